@@ -11,6 +11,7 @@
 #define BOOST_TAAR_CORE_ASYNC_GENERATOR_HPP
 
 #include <boost/taar/core/awaitable.hpp>
+#include <boost/taar/core/frame_allocator.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/asio/as_tuple.hpp>
 #include <boost/asio/async_result.hpp>
@@ -29,16 +30,17 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <cstddef>
 
 namespace boost::taar {
 
-template <typename T>
+template <typename T, typename ExecutorType = default_executor>
 class async_generator
 {
 public:
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
-    using executor_type = boost::asio::io_context::executor_type;
+    using executor_type = ExecutorType;
     using completion_handler_type = std::move_only_function<void(std::optional<T>)>;
 
     struct promise_type
@@ -48,6 +50,17 @@ public:
             return async_generator{handle_type::from_promise(*this)};
         }
 
+        // Frames are recycled instead of going back to the heap.
+        static void* operator new(std::size_t size)
+        {
+            return frame_allocator::allocate(size);
+        }
+
+        static void operator delete(void* pointer, std::size_t size) noexcept
+        {
+            frame_allocator::deallocate(pointer, size);
+        }
+
         std::suspend_always initial_suspend() noexcept { return {}; }
 
         struct final_awaiter
@@ -319,7 +332,7 @@ public:
         // Flattening awaiter for yielding inner generators
         struct flatten_awaiter
         {
-            async_generator<T> inner;
+            async_generator inner;
 
             bool await_ready() noexcept { return false; }
 
@@ -415,7 +428,7 @@ public:
                         };
 
                         boost::asio::co_spawn(exec,
-                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                             {
                                 co_return co_await inner_ptr->next();
                             },
@@ -426,7 +439,7 @@ public:
                     else
                     {
                         boost::asio::co_spawn(exec,
-                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                             {
                                 co_return co_await inner_ptr->next();
                             },
@@ -441,7 +454,7 @@ public:
             }
         };
 
-        flatten_awaiter yield_value(async_generator<T> inner)
+        flatten_awaiter yield_value(async_generator inner)
         {
             return {std::move(inner)};
         }
@@ -485,8 +498,8 @@ public:
 
         // Flattening state
         std::shared_ptr<boost::asio::cancellation_signal> flattening_cancel_signal_;
-        std::optional<async_generator<T>> flattening_inner_storage_;
-        async_generator<T>* flattening_inner_ = nullptr;
+        std::optional<async_generator> flattening_inner_storage_;
+        async_generator* flattening_inner_ = nullptr;
         handle_type flattening_outer_handle_ = nullptr;
     };
 
@@ -718,7 +731,7 @@ private:
                 };
 
                 boost::asio::co_spawn(exec,
-                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                     {
                         co_return co_await inner->next();
                     },
@@ -729,7 +742,7 @@ private:
             else
             {
                 boost::asio::co_spawn(exec,
-                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                     {
                         co_return co_await inner->next();
                     },
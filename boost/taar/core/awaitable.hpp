@@ -17,17 +17,19 @@
 
 namespace boost::taar {
 
-template <typename T>
-using awaitable = boost::asio::awaitable<T, boost::asio::io_context::executor_type>;
+// Executor of the taar coroutines unless another one is specified, e.g. a
+// strand or the executor of a thread pool.
+using default_executor = boost::asio::io_context::executor_type;
+
+template <typename T, typename ExecutorType = default_executor>
+using awaitable = boost::asio::awaitable<T, ExecutorType>;
 
 // Completion token for use in async operations within taar coroutines
-inline constexpr boost::asio::use_awaitable_t<
-    boost::asio::io_context::executor_type> use_awaitable{};
+inline constexpr boost::asio::use_awaitable_t<default_executor> use_awaitable{};
 
 // Tuple-style completion token (returns error_code instead of throwing)
 inline constexpr boost::asio::as_tuple_t<
-    boost::asio::use_awaitable_t<
-        boost::asio::io_context::executor_type>> use_awaitable_tuple{};
+    boost::asio::use_awaitable_t<default_executor>> use_awaitable_tuple{};
 
 } // namespace boost::taar
 
@@ -11,47 +11,310 @@
 #define BOOST_TAAR_CORE_CANCELLATION_SIGNALS_HPP
 
 #include <boost/asio/cancellation_signal.hpp>
-#include <list>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/consign.hpp>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace boost::taar {
 
+// Pool of cancellation signals which can all be emitted at once, e.g. to stop
+// the servers and their sessions. The signals are allocated in chunks which
+// are never moved, and the free signals are kept in lock-free free lists, so
+// acquiring and releasing a signal doesn't depend on the number of signals in
+// use. The free lists are sharded by thread to keep the threads of different
+// io_contexts from contending for the same list.
 class cancellation_signals
 {
+    class pool;
+
 public:
+    // Max number of signals of the pool.
+    static constexpr std::size_t chunk_size = 256;
+    static constexpr std::size_t max_chunks = 4096;
+
+    explicit cancellation_signals(
+            std::size_t shard_count = std::max(std::thread::hardware_concurrency(), 1u))
+        : pool_ {std::make_shared<pool>(std::max<std::size_t>(shard_count, 1))}
+    {}
+
+    cancellation_signals(cancellation_signals const&) = delete;
+    cancellation_signals& operator=(cancellation_signals const&) = delete;
+
     void emit(boost::asio::cancellation_type ct = boost::asio::cancellation_type::all)
     {
-        std::lock_guard<std::mutex> const lock{mutex_};
-        for (auto& signal: signals_)
-        {
-            signal.emit(ct);
-        }
+        pool_->emit(ct);
     }
 
+    // Slot of a signal which is reserved for the lifetime of the pool. A
+    // reserved signal whose slot has no handler is handed out again, so only
+    // the slots in use at once take signals of the pool. Prefer bind, which
+    // doesn't have to look for a free one.
     boost::asio::cancellation_slot slot()
     {
-        std::lock_guard<std::mutex> const lock{mutex_};
+        return pool_->reserved_slot();
+    }
+
+    // Binds the completion token to the slot of a signal which goes back to
+    // the pool once the completion handler is destroyed. The handler keeps
+    // the pool alive, so it can outlive this object.
+    template <typename CompletionToken>
+    auto bind(CompletionToken&& token)
+    {
+        lease signal {pool_};
+        auto const slot = signal.slot();
+        return boost::asio::bind_cancellation_slot(
+            slot,
+            boost::asio::consign(
+                std::forward<CompletionToken>(token),
+                std::move(signal)));
+    }
+
+private:
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    struct entry
+    {
+        boost::asio::cancellation_signal signal;
+        std::atomic<std::uint32_t> next = npos;
+        std::atomic<bool> in_use = false;
+        std::uint32_t index = 0;
+    };
+
+    struct chunk
+    {
+        std::array<entry, chunk_size> entries;
+    };
+
+    static constexpr std::uint64_t pack(std::uint32_t index, std::uint32_t tag) noexcept
+    {
+        return (static_cast<std::uint64_t>(tag) << 32) | index;
+    }
+
+    static constexpr std::uint32_t index_of(std::uint64_t head) noexcept
+    {
+        return static_cast<std::uint32_t>(head);
+    }
+
+    static constexpr std::uint32_t tag_of(std::uint64_t head) noexcept
+    {
+        return static_cast<std::uint32_t>(head >> 32);
+    }
+
+    // Head of a free list as the index of the first entry and a tag which
+    // changes on every update to prevent ABA.
+    struct alignas(64) shard
+    {
+        std::atomic<std::uint64_t> head = pack(npos, 0);
+    };
+
+    class pool
+    {
+    public:
+        explicit pool(std::size_t shard_count)
+            : shard_count_ {shard_count}
+            , shards_ {std::make_unique<shard[]>(shard_count)}
+        {}
+
+        pool(pool const&) = delete;
+        pool& operator=(pool const&) = delete;
 
-        auto itr = std::find_if(
-            signals_.begin(),
-            signals_.end(),
-            [](boost::asio::cancellation_signal& signal)
+        ~pool()
+        {
+            for (auto& chunk : chunks_)
             {
-                return !signal.slot().has_handler();
-            });
+                delete chunk.load(std::memory_order_relaxed);
+            }
+        }
 
-        if (itr != signals_.end())
+        void emit(boost::asio::cancellation_type ct)
         {
-            return itr->slot();
+            auto const count = std::min(
+                chunk_count_.load(std::memory_order_acquire),
+                max_chunks);
+            for (std::size_t index = 0; index != count; ++index)
+            {
+                // A chunk might be reserved but not yet published.
+                auto* chunk = chunks_[index].load(std::memory_order_acquire);
+                if (!chunk)
+                {
+                    continue;
+                }
+
+                for (auto& item : chunk->entries)
+                {
+                    if (item.in_use.load(std::memory_order_acquire))
+                    {
+                        item.signal.emit(ct);
+                    }
+                }
+            }
         }
 
-        return signals_.emplace_back().slot();
-    }
+        entry& acquire()
+        {
+            auto& free_list = local_shard();
+            auto head = free_list.head.load(std::memory_order_acquire);
+            while (index_of(head) != npos)
+            {
+                auto& item = entry_at(index_of(head));
+                auto const next = pack(
+                    item.next.load(std::memory_order_relaxed),
+                    tag_of(head) + 1);
+                if (free_list.head.compare_exchange_weak(
+                    head,
+                    next,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire))
+                {
+                    item.in_use.store(true, std::memory_order_release);
+                    return item;
+                }
+            }
 
-private:
-    std::list<boost::asio::cancellation_signal> signals_;
-    std::mutex mutex_;
+            return grow(free_list);
+        }
+
+        void release(entry& item) noexcept
+        {
+            item.in_use.store(false, std::memory_order_release);
+            push(local_shard(), item, item);
+        }
+
+        boost::asio::cancellation_slot reserved_slot()
+        {
+            std::lock_guard<std::mutex> const lock {reserved_mutex_};
+
+            auto itr = std::find_if(
+                reserved_.begin(),
+                reserved_.end(),
+                [](entry const* item)
+                {
+                    return !item->signal.slot().has_handler();
+                });
+
+            if (itr != reserved_.end())
+            {
+                return (*itr)->signal.slot();
+            }
+
+            reserved_.reserve(reserved_.size() + 1);
+            auto& item = acquire();
+            reserved_.push_back(&item);
+            return item.signal.slot();
+        }
+
+    private:
+        entry& entry_at(std::uint32_t index) const noexcept
+        {
+            auto* chunk = chunks_[index / chunk_size].load(std::memory_order_acquire);
+            return chunk->entries[index % chunk_size];
+        }
+
+        shard& local_shard() const noexcept
+        {
+            static std::atomic<std::size_t> thread_count = 0;
+            thread_local std::size_t const thread_index = thread_count++;
+            return shards_[thread_index % shard_count_];
+        }
+
+        // Pushes the linked entries from first to last to the free list.
+        static void push(shard& free_list, entry& first, entry& last) noexcept
+        {
+            auto head = free_list.head.load(std::memory_order_relaxed);
+            do
+            {
+                last.next.store(index_of(head), std::memory_order_relaxed);
+            }
+            while (!free_list.head.compare_exchange_weak(
+                head,
+                pack(first.index, tag_of(head) + 1),
+                std::memory_order_release,
+                std::memory_order_relaxed));
+        }
+
+        // Allocates a new chunk, takes its first entry and gives the rest to
+        // the free list.
+        entry& grow(shard& free_list)
+        {
+            auto const index = chunk_count_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= max_chunks)
+            {
+                throw std::length_error {"Too many cancellation signals"};
+            }
+
+            auto* new_chunk = new chunk;
+            auto& entries = new_chunk->entries;
+            for (std::size_t offset = 0; offset != chunk_size; ++offset)
+            {
+                entries[offset].index = static_cast<std::uint32_t>(index * chunk_size + offset);
+                if (offset + 1 != chunk_size)
+                {
+                    entries[offset].next.store(
+                        entries[offset].index + 1,
+                        std::memory_order_relaxed);
+                }
+            }
+            entries.front().in_use.store(true, std::memory_order_relaxed);
+            chunks_[index].store(new_chunk, std::memory_order_release);
+
+            push(free_list, entries[1], entries.back());
+            return entries.front();
+        }
+
+        std::size_t shard_count_;
+        std::unique_ptr<shard[]> shards_;
+        std::atomic<std::size_t> chunk_count_ = 0;
+        std::array<std::atomic<chunk*>, max_chunks> chunks_ {};
+        std::vector<entry*> reserved_;
+        std::mutex reserved_mutex_;
+    };
+
+    // Returns the signal to the pool once it's destroyed.
+    class lease
+    {
+    public:
+        explicit lease(std::shared_ptr<pool> owner)
+            : owner_ {std::move(owner)}
+            , entry_ {&owner_->acquire()}
+        {}
+
+        lease(lease&& other) noexcept
+            : owner_ {std::move(other.owner_)}
+            , entry_ {std::exchange(other.entry_, nullptr)}
+        {}
+
+        lease& operator=(lease&&) = delete;
+
+        ~lease()
+        {
+            if (entry_)
+            {
+                owner_->release(*entry_);
+            }
+        }
+
+        boost::asio::cancellation_slot slot() const
+        {
+            return entry_->signal.slot();
+        }
+
+    private:
+        std::shared_ptr<pool> owner_;
+        entry* entry_;
+    };
+
+    std::shared_ptr<pool> pool_;
 };
 
 } // namespace boost::taar
@@ -13,6 +13,7 @@
 #include <boost/taar/core/awaitable.hpp>
 #include <boost/taar/core/chunked_response_meta.hpp>
 #include <boost/taar/core/error.hpp>
+#include <boost/taar/core/frame_allocator.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/asio/as_tuple.hpp>
 #include <boost/asio/async_result.hpp>
@@ -37,13 +38,13 @@
 
 namespace boost::taar {
 
-template <typename T>
+template <typename T, typename ExecutorType = default_executor>
 class chunked_response
 {
 public:
     struct promise_type;
     using handle_type = std::coroutine_handle<promise_type>;
-    using executor_type = boost::asio::io_context::executor_type;
+    using executor_type = ExecutorType;
     using completion_handler_type = std::move_only_function<void(std::optional<T>)>;
 
     struct promise_type
@@ -53,6 +54,17 @@ public:
             return chunked_response{handle_type::from_promise(*this)};
         }
 
+        // Frames are recycled instead of going back to the heap.
+        static void* operator new(std::size_t size)
+        {
+            return frame_allocator::allocate(size);
+        }
+
+        static void operator delete(void* pointer, std::size_t size) noexcept
+        {
+            frame_allocator::deallocate(pointer, size);
+        }
+
         std::suspend_always initial_suspend() noexcept { return {}; }
 
         struct final_awaiter
@@ -148,7 +160,7 @@ public:
         // Flattening awaiter for yielding inner chunked_response generators
         struct flatten_awaiter
         {
-            chunked_response<T> inner;
+            chunked_response inner;
 
             bool await_ready() noexcept { return false; }
 
@@ -244,7 +256,7 @@ public:
                         };
 
                         boost::asio::co_spawn(exec,
-                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                             {
                                 co_return co_await inner_ptr->next();
                             },
@@ -255,7 +267,7 @@ public:
                     else
                     {
                         boost::asio::co_spawn(exec,
-                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                            [inner_ptr]() -> boost::taar::awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                             {
                                 co_return co_await inner_ptr->next();
                             },
@@ -270,7 +282,7 @@ public:
             }
         };
 
-        flatten_awaiter yield_value(chunked_response<T> inner)
+        flatten_awaiter yield_value(chunked_response inner)
         {
             // Note: Inner's metadata is intentionally ignored - only outer's metadata is used
             data_yielded_ = true;  // Yielding an inner generator counts as data yield
@@ -513,8 +525,8 @@ public:
         std::shared_ptr<boost::asio::cancellation_signal> flattening_cancel_signal_;
 
         // Flattening state
-        std::optional<chunked_response<T>> flattening_inner_storage_;
-        chunked_response<T>* flattening_inner_ = nullptr;
+        std::optional<chunked_response> flattening_inner_storage_;
+        chunked_response* flattening_inner_ = nullptr;
         handle_type flattening_outer_handle_ = nullptr;
     };
 
@@ -760,7 +772,7 @@ private:
                 };
 
                 boost::asio::co_spawn(exec,
-                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                     {
                         co_return co_await inner->next();
                     },
@@ -771,7 +783,7 @@ private:
             else
             {
                 boost::asio::co_spawn(exec,
-                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>>
+                    [inner]() -> awaitable<std::tuple<boost::system::error_code, std::optional<T>>, executor_type>
                     {
                         co_return co_await inner->next();
                     },
@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_CORE_COALESCING_STREAM_HPP
+#define BOOST_TAAR_CORE_COALESCING_STREAM_HPP
+
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/append.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace boost::taar {
+
+// Stream which holds back small writes and sends them to the next layer in a
+// single write. The pending bytes are flushed when they would exceed the
+// capacity, when they are explicitly flushed and before any read from the next
+// layer, so the peer never waits for data which is held back. Writes larger
+// than the capacity go to the next layer directly.
+template <typename NextLayer>
+class coalescing_stream
+{
+public:
+    using next_layer_type = std::remove_reference_t<NextLayer>;
+    using executor_type = typename next_layer_type::executor_type;
+
+    static constexpr std::size_t default_capacity = 16 * 1024;
+
+    template <typename Arg>
+    explicit coalescing_stream(Arg&& arg, std::size_t capacity = default_capacity)
+        : next_layer_ {std::forward<Arg>(arg)}
+        , capacity_ {capacity}
+    {}
+
+    executor_type get_executor() noexcept
+    {
+        return next_layer_.get_executor();
+    }
+
+    next_layer_type& next_layer() noexcept
+    {
+        return next_layer_;
+    }
+
+    next_layer_type const& next_layer() const noexcept
+    {
+        return next_layer_;
+    }
+
+    // Number of bytes written to the stream but not yet to the next layer.
+    std::size_t pending_size() const noexcept
+    {
+        return pending_.size();
+    }
+
+    template <
+        typename ConstBufferSequence,
+        typename WriteToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_write_some(
+        ConstBufferSequence const& buffers,
+        WriteToken&& token = WriteToken {})
+    {
+        return boost::asio::async_compose<
+            WriteToken,
+            void(boost::system::error_code, std::size_t)>(
+                write_some_op<ConstBufferSequence> {*this, buffers},
+                std::forward<WriteToken>(token),
+                next_layer_);
+    }
+
+    template <
+        typename MutableBufferSequence,
+        typename ReadToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_read_some(
+        MutableBufferSequence const& buffers,
+        ReadToken&& token = ReadToken {})
+    {
+        return boost::asio::async_compose<
+            ReadToken,
+            void(boost::system::error_code, std::size_t)>(
+                read_some_op<MutableBufferSequence> {*this, buffers},
+                std::forward<ReadToken>(token),
+                next_layer_);
+    }
+
+    // Writes the pending bytes to the next layer.
+    template <
+        typename FlushToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_flush(FlushToken&& token = FlushToken {})
+    {
+        return boost::asio::async_compose<
+            FlushToken,
+            void(boost::system::error_code, std::size_t)>(
+                flush_op {*this},
+                std::forward<FlushToken>(token),
+                next_layer_);
+    }
+
+private:
+    enum class op_state
+    {
+        starting,
+        flushing,
+        transferring,
+    };
+
+    template <typename ConstBufferSequence>
+    struct write_some_op
+    {
+        coalescing_stream& stream;
+        ConstBufferSequence buffers;
+        op_state state = op_state::starting;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            boost::system::error_code ec = {},
+            std::size_t size = 0)
+        {
+            switch (state)
+            {
+            case op_state::starting:
+                break;
+
+            case op_state::flushing:
+                stream.pending_.consume(size);
+                if (ec)
+                {
+                    return self.complete(ec, 0);
+                }
+                break;
+
+            case op_state::transferring:
+                return self.complete(ec, size);
+            }
+
+            auto const requested = boost::asio::buffer_size(buffers);
+            if (stream.pending_.size() + requested <= stream.capacity_)
+            {
+                // The bytes are kept and the operation completes right away,
+                // but never before the initiating function returns.
+                stream.pending_.commit(boost::asio::buffer_copy(
+                    stream.pending_.prepare(requested),
+                    buffers));
+                state = op_state::transferring;
+                return boost::asio::post(
+                    stream.get_executor(),
+                    boost::asio::append(
+                        std::move(self),
+                        boost::system::error_code {},
+                        requested));
+            }
+
+            if (stream.pending_.size() != 0)
+            {
+                state = op_state::flushing;
+                return boost::asio::async_write(
+                    stream.next_layer_,
+                    stream.pending_.data(),
+                    std::move(self));
+            }
+
+            state = op_state::transferring;
+            stream.next_layer_.async_write_some(buffers, std::move(self));
+        }
+    };
+
+    template <typename MutableBufferSequence>
+    struct read_some_op
+    {
+        coalescing_stream& stream;
+        MutableBufferSequence buffers;
+        op_state state = op_state::starting;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            boost::system::error_code ec = {},
+            std::size_t size = 0)
+        {
+            switch (state)
+            {
+            case op_state::starting:
+                if (stream.pending_.size() != 0)
+                {
+                    state = op_state::flushing;
+                    return boost::asio::async_write(
+                        stream.next_layer_,
+                        stream.pending_.data(),
+                        std::move(self));
+                }
+                break;
+
+            case op_state::flushing:
+                stream.pending_.consume(size);
+                if (ec)
+                {
+                    return self.complete(ec, 0);
+                }
+                break;
+
+            case op_state::transferring:
+                return self.complete(ec, size);
+            }
+
+            state = op_state::transferring;
+            stream.next_layer_.async_read_some(buffers, std::move(self));
+        }
+    };
+
+    struct flush_op
+    {
+        coalescing_stream& stream;
+        op_state state = op_state::starting;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            boost::system::error_code ec = {},
+            std::size_t size = 0)
+        {
+            if (state == op_state::starting)
+            {
+                state = op_state::flushing;
+                return boost::asio::async_write(
+                    stream.next_layer_,
+                    stream.pending_.data(),
+                    std::move(self));
+            }
+
+            stream.pending_.consume(size);
+            self.complete(ec, size);
+        }
+    };
+
+    NextLayer next_layer_;
+    boost::beast::flat_buffer pending_;
+    std::size_t capacity_;
+};
+
+} // namespace boost::taar
+
+#endif // BOOST_TAAR_CORE_COALESCING_STREAM_HPP
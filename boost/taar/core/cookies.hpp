@@ -12,10 +12,18 @@
 
 #include <boost/taar/core/error.hpp>
 #include <boost/url/decode_view.hpp>
+#include <boost/url/pct_string_view.hpp>
 #include <boost/url/grammar/all_chars.hpp>
 #include <boost/url/grammar/lut_chars.hpp>
 #include <boost/system/result.hpp>
 #include <unordered_map>
+#include <forward_list>
+#include <memory_resource>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <utility>
+#include <cstddef>
 #include <string_view>
 #include <string>
 
@@ -35,8 +43,162 @@ constexpr auto cookie_unquoted_octet_chars =
     cookie_quoted_octet_chars -
     boost::urls::grammar::lut_chars {" \",;\\"};
 
+// Scans a Cookie header and calls the handler with the name and the value of
+// each cookie as they appear in the header. The views refer to the specified
+// string, so nothing is copied or decoded. The cookies before an invalid one
+// are still reported.
+template <typename HandlerType>
+error scan_cookies(std::string_view cookie_string, HandlerType&& handler)
+{
+    enum class states
+    {
+        name_start,
+        name,
+        value_start,
+        value_quoted,
+        value_quoted_end,
+        value_unquoted,
+        separator,
+    };
+
+    std::size_t name_begin = 0;
+    std::size_t name_end = 0;
+    std::size_t value_begin = 0;
+    std::size_t value_end = 0;
+    states state = states::name_start;
+
+    auto const emit = [&]
+    {
+        handler(
+            cookie_string.substr(name_begin, name_end - name_begin),
+            cookie_string.substr(value_begin, value_end - value_begin));
+    };
+
+    for (std::size_t i = 0; i != cookie_string.size(); ++i)
+    {
+        auto const ch = cookie_string[i];
+        switch (state)
+        {
+        case states::separator:
+            if (ch == ' ')
+            {
+                state = states::name_start;
+                break;
+            }
+            [[fallthrough]];
+
+        case states::name_start:
+            if (!token_chars(ch))
+            {
+                return error::invalid_cookie_format;
+            }
+            name_begin = i;
+            state = states::name;
+            break;
+
+        case states::name:
+            if (ch == '=')
+            {
+                name_end = i;
+                value_begin = value_end = i + 1;
+                state = states::value_start;
+            }
+            else if (!token_chars(ch))
+            {
+                return error::invalid_cookie_format;
+            }
+            break;
+
+        case states::value_start:
+            if (ch == ';')
+            {
+                emit();
+                state = states::separator;
+            }
+            else if (ch == '"')
+            {
+                value_begin = value_end = i + 1;
+                state = states::value_quoted;
+            }
+            else if (cookie_unquoted_octet_chars(ch))
+            {
+                value_end = i + 1;
+                state = states::value_unquoted;
+            }
+            else
+            {
+                return error::invalid_cookie_format;
+            }
+            break;
+
+        case states::value_unquoted:
+            if (ch == ';')
+            {
+                emit();
+                state = states::separator;
+            }
+            else if (cookie_unquoted_octet_chars(ch))
+            {
+                value_end = i + 1;
+            }
+            else
+            {
+                return error::invalid_cookie_format;
+            }
+            break;
+
+        case states::value_quoted:
+            if (ch == '"')
+            {
+                value_end = i;
+                emit();
+                state = states::value_quoted_end;
+            }
+            else if (!cookie_quoted_octet_chars(ch))
+            {
+                return error::invalid_cookie_format;
+            }
+            break;
+
+        case states::value_quoted_end:
+            if (ch != ';')
+            {
+                return error::invalid_cookie_format;
+            }
+            state = states::separator;
+            break;
+        }
+    }
+
+    if (state == states::name || state == states::value_quoted)
+    {
+        return error::invalid_cookie_format;
+    }
+
+    if (state == states::value_start || state == states::value_unquoted)
+    {
+        emit();
+    }
+
+    return error::success;
+}
+
+// Percent-decodes a cookie name or value.
+inline std::string decode_cookie_part(std::string_view part)
+{
+    if (part.find('%') == std::string_view::npos)
+    {
+        return std::string {part};
+    }
+
+    boost::urls::decode_view const decoded {boost::urls::pct_string_view {part}};
+    return std::string {decoded.begin(), decoded.end()};
+}
+
 } // namespace detail
 
+class cookies_view;
+
 struct cookie
 {
     std::string name;
@@ -82,6 +244,9 @@ public:
         : items_(init)
     {}
 
+    // Copies and decodes the cookies of the view.
+    cookies(cookies_view const& view);
+
     [[nodiscard]] size_type size() const noexcept
     {
         return items_.size();
@@ -179,176 +344,279 @@ public:
 
     friend error parse_cookies(std::string_view cookie_string, cookies& result)
     {
-        enum class states
+        return detail::scan_cookies(
+            cookie_string,
+            [&](std::string_view name, std::string_view value)
+            {
+                result.items_.emplace(
+                    detail::decode_cookie_part(name),
+                    detail::decode_cookie_part(value));
+            });
+    }
+
+    friend boost::system::result<cookies, error> parse_cookies(
+        std::string_view cookie_string)
+    {
+        cookies result;
+        auto e = parse_cookies(cookie_string, result);
+        if (e != error::success)
+            return e;
+
+        return result;
+    }
+
+    [[nodiscard]] friend bool operator==(cookies const& lhs, cookies const& rhs)
+    {
+        return lhs.items_ == rhs.items_;
+    }
+
+    [[nodiscard]] friend bool operator!=(cookies const& lhs, cookies const& rhs)
+    {
+        return lhs.items_ != rhs.items_;
+    }
+
+private:
+    items_type items_;
+};
+
+// Cookies of the Cookie headers of a request without copying them. The headers
+// are scanned once and the names and values are kept as views into them in a
+// flat array. A value is only percent-decoded if it contains a '%', the first
+// time it is asked for. Looking up a name doesn't allocate. The cookies over the
+// inline capacity and the decoded values are allocated with the allocator of
+// the view. The viewed strings must outlive the view.
+class cookies_view
+{
+public:
+    class value_type
+    {
+    public:
+        value_type() = default;
+
+        // The name and value are either as they appear in the header or are
+        // already decoded.
+        value_type(std::string_view name, std::string_view value, bool decoded = false)
+            : name_ {name}
+            , encoded_ {value}
+            , value_ {value}
+            , decoded_ {decoded}
+            , pending_ {!decoded && value.find('%') != std::string_view::npos}
+        {}
+
+        // The name as it appears in the header.
+        std::string_view encoded_name() const noexcept
+        {
+            return name_;
+        }
+
+        // The value as it appears in the header.
+        std::string_view encoded_value() const noexcept
         {
-            name_start,
-            name,
-            value_start,
-            value_quoted,
-            value_quoted_end,
-            value_unquoted,
-            separator,
-        };
-
-        std::string name;
-        std::string value;
-        states state = states::name_start;
-
-        for (char ch : cookie_string)
+            return encoded_;
+        }
+
+        // The decoded name.
+        std::string name() const
+        {
+            return decoded_ ? std::string {name_} : detail::decode_cookie_part(name_);
+        }
+
+        // Whether the decoded name equals the specified name.
+        bool name_equals(std::string_view name) const
         {
-            switch (state)
+            if (decoded_ || name_.find('%') == std::string_view::npos)
             {
-            case states::separator:
-                if (ch == ' ')
-                {
-                    state = states::name_start;
-                    break;
-                }
-                [[fallthrough]];
-
-            case states::name_start:
-                if (!detail::token_chars(ch))
-                {
-                    return error::invalid_cookie_format;
-                }
-                name = ch;
-                state = states::name;
-                break;
+                return name_ == name;
+            }
 
-            case states::name:
-                if (ch == '=')
-                {
-                    value.clear();
-                    state = states::value_start;
-                }
-                else if (detail::token_chars(ch))
-                {
-                    name.push_back(ch);
-                }
-                else
-                {
-                    return error::invalid_cookie_format;
-                }
-                break;
+            return (*boost::urls::pct_string_view {name_}).compare(name) == 0;
+        }
 
-            case states::value_start:
-                if (ch == ';')
-                {
-                    boost::urls::decode_view decoded_name {name};
-                    result.items_.emplace(
-                        std::string(decoded_name.begin(), decoded_name.end()),
-                        std::string());
-                    state = states::separator;
-                }
-                else if (ch == '"')
-                {
-                    state = states::value_quoted;
-                }
-                else if (detail::cookie_unquoted_octet_chars(ch))
-                {
-                    state = states::value_unquoted;
-                    value.push_back(ch);
-                }
-                else
-                {
-                    return error::invalid_cookie_format;
-                }
-                break;
+    private:
+        friend class cookies_view;
 
-            case states::value_unquoted:
-                if (ch == ';')
-                {
-                    boost::urls::decode_view decoded_name {name};
-                    boost::urls::decode_view decoded_value {value};
-                    result.items_.emplace(
-                        std::string(decoded_name.begin(), decoded_name.end()),
-                        std::string(decoded_value.begin(), decoded_value.end()));
-                    state = states::separator;
-                }
-                else if (detail::cookie_unquoted_octet_chars(ch))
-                {
-                    value.push_back(ch);
-                }
-                else
-                {
-                    return error::invalid_cookie_format;
-                }
-                break;
+        std::string_view name_;
+        std::string_view encoded_;
+        mutable std::string_view value_;
+        bool decoded_ = false;
+        mutable bool pending_ = false;
+    };
 
-            case states::value_quoted:
-                if (ch == '"')
-                {
-                    boost::urls::decode_view decoded_name {name};
-                    boost::urls::decode_view decoded_value {value};
-                    result.items_.emplace(
-                        std::string(decoded_name.begin(), decoded_name.end()),
-                        std::string(decoded_value.begin(), decoded_value.end()));
-                    state = states::value_quoted_end;
-                }
-                else if (detail::cookie_quoted_octet_chars(ch))
-                {
-                    value.push_back(ch);
-                }
-                else
-                {
-                    return error::invalid_cookie_format;
-                }
-                break;
+    using const_iterator = value_type const*;
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
 
-            case states::value_quoted_end:
-                if (ch != ';')
-                {
-                    return error::invalid_cookie_format;
-                }
-                state = states::separator;
-                break;
-            }
+    static constexpr size_type inline_capacity = 16;
+
+    cookies_view() = default;
+
+    explicit cookies_view(allocator_type allocator)
+        : overflow_ {allocator}
+        , decoded_ {allocator}
+    {}
+
+    // Views the names and values of the specified cookies.
+    cookies_view(cookies const& jar)
+    {
+        // The values are already decoded.
+        for (auto const& [name, value] : jar)
+        {
+            push_back(value_type {name, value, true});
         }
+    }
 
-        if (state == states::name || state == states::value_quoted)
+    // Copies refer to the same headers and decode the values again if needed.
+    // They use the default memory resource.
+    cookies_view(cookies_view const& other)
+    {
+        *this = other;
+    }
+
+    cookies_view& operator=(cookies_view const& other)
+    {
+        if (this != &other)
         {
-            return error::invalid_cookie_format;
+            clear();
+            for (auto const& cookie : other)
+            {
+                auto copy = cookie;
+                copy.value_ = copy.encoded_;
+                copy.pending_ =
+                    !copy.decoded_ &&
+                    copy.encoded_.find('%') != std::string_view::npos;
+                push_back(copy);
+            }
         }
 
-        if (state == states::value_start ||
-            state == states::value_unquoted ||
-            state == states::value_quoted_end)
+        return *this;
+    }
+
+    cookies_view(cookies_view&& other) noexcept
+        : inline_ {std::move(other.inline_)}
+        , overflow_ {std::move(other.overflow_)}
+        , decoded_ {std::move(other.decoded_)}
+        , size_ {std::exchange(other.size_, 0)}
+    {}
+
+    cookies_view& operator=(cookies_view&& other)
+    {
+        inline_ = std::move(other.inline_);
+        overflow_ = std::move(other.overflow_);
+        decoded_ = std::move(other.decoded_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    // Scans a Cookie header and adds its cookies. The cookies before an invalid
+    // one are still added.
+    error append(std::string_view cookie_string)
+    {
+        return detail::scan_cookies(
+            cookie_string,
+            [this](std::string_view name, std::string_view value)
+            {
+                push_back(value_type {name, value});
+            });
+    }
+
+    // The first cookie with the specified decoded name.
+    const_iterator find(std::string_view name) const
+    {
+        return std::find_if(
+            begin(),
+            end(),
+            [name](value_type const& cookie)
+            {
+                return cookie.name_equals(name);
+            });
+    }
+
+    bool contains(std::string_view name) const
+    {
+        return find(name) != end();
+    }
+
+    // The decoded value of the cookie.
+    std::string_view value(value_type const& cookie) const
+    {
+        if (cookie.pending_)
         {
-            boost::urls::decode_view decoded_name {name};
-            boost::urls::decode_view decoded_value {value};
-            result.items_.emplace(
-                std::string(decoded_name.begin(), decoded_name.end()),
-                std::string(decoded_value.begin(), decoded_value.end()));
+            cookie.pending_ = false;
+            boost::urls::decode_view const decoded {
+                boost::urls::pct_string_view {cookie.value_}};
+            cookie.value_ = decoded_.emplace_front(decoded.begin(), decoded.end());
         }
 
-        return error::success;
+        return cookie.value_;
     }
 
-    friend boost::system::result<cookies, error> parse_cookies(
-        std::string_view cookie_string)
+    const_iterator begin() const noexcept
     {
-        cookies result;
-        auto e = parse_cookies(cookie_string, result);
-        if (e != error::success)
-            return e;
+        return size_ <= inline_capacity ? inline_.data() : overflow_.data();
+    }
 
-        return result;
+    const_iterator end() const noexcept
+    {
+        return begin() + size_;
     }
 
-    [[nodiscard]] friend bool operator==(cookies const& lhs, cookies const& rhs)
+    size_type size() const noexcept
     {
-        return lhs.items_ == rhs.items_;
+        return size_;
     }
 
-    [[nodiscard]] friend bool operator!=(cookies const& lhs, cookies const& rhs)
+    bool empty() const noexcept
     {
-        return lhs.items_ != rhs.items_;
+        return size_ == 0;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return overflow_.get_allocator();
+    }
+
+    // Removes all the cookies and gives back their memory, so the memory
+    // resource of the view can be released afterwards.
+    void clear() noexcept
+    {
+        std::pmr::vector<value_type> {overflow_.get_allocator()}.swap(overflow_);
+        decoded_.clear();
+        size_ = 0;
     }
 
 private:
-    items_type items_;
+    void push_back(value_type const& cookie)
+    {
+        if (size_ < inline_capacity)
+        {
+            inline_[size_] = cookie;
+        }
+        else
+        {
+            if (size_ == inline_capacity)
+            {
+                overflow_.assign(inline_.begin(), inline_.end());
+            }
+            overflow_.push_back(cookie);
+        }
+
+        ++size_;
+    }
+
+    std::array<value_type, inline_capacity> inline_;
+    std::pmr::vector<value_type> overflow_;
+    mutable std::pmr::forward_list<std::pmr::string> decoded_;
+    size_type size_ = 0;
 };
 
+inline cookies::cookies(cookies_view const& view)
+{
+    for (auto const& cookie : view)
+    {
+        items_.emplace(cookie.name(), std::string {view.value(cookie)});
+    }
+}
+
 } // namespace boost::taar
 
 #endif // BOOST_TAAR_CORE_COOKIES_HPP
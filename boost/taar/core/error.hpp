@@ -29,6 +29,7 @@ enum class error
     invalid_boolean_format,
     invalid_number_format,
     late_chunk_metadata,
+    invalid_uuid_format,
 };
 
 #if (__cpp_constexpr >= 202211L)
@@ -73,6 +74,8 @@ inline boost::system::error_category const& error_category() noexcept
                 return "Invalid number format";
             case error::late_chunk_metadata:
                 return "Chunk metadata yielded after data.";
+            case error::invalid_uuid_format:
+                return "Invalid UUID format";
             }
 
             return "(Unknown error)";
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_CORE_FRAME_ALLOCATOR_HPP
+#define BOOST_TAAR_CORE_FRAME_ALLOCATOR_HPP
+
+#include <array>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost::taar {
+
+// Recycling allocator of coroutine frames. Freed frames are kept in per-thread
+// free lists of power of two size classes and handed out again to the next
+// frames of the same class, so a steady flow of requests doesn't allocate
+// frames from the heap. Frames larger than the largest class always use the
+// heap. A frame can be freed on any thread. The frames of asio awaitables are
+// recycled by asio itself, up to BOOST_ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE
+// frames per thread. Its default of two is less than the nested awaitables of
+// a request, so applications are advised to raise it, e.g. to 16. It must be
+// the same in every translation unit of the program.
+class frame_allocator
+{
+public:
+    static constexpr std::size_t min_size = 64;
+    static constexpr std::size_t class_count = 8;
+    static constexpr std::size_t max_size = min_size << (class_count - 1);
+
+    // Max number of free frames which are kept per size class and thread.
+    static constexpr std::size_t max_cached = 64;
+
+    // Statistics of the calling thread.
+    struct statistics
+    {
+        // Frames handed out, and how many of them were recycled.
+        std::uint64_t allocations = 0;
+        std::uint64_t recycled = 0;
+
+        // Frames freed, and how many of them were kept for reuse.
+        std::uint64_t deallocations = 0;
+        std::uint64_t cached = 0;
+    };
+
+    static void* allocate(std::size_t size)
+    {
+        auto& pool = thread_pool();
+        ++pool.stats.allocations;
+
+        auto const index = class_of(size);
+        if (index == class_count)
+        {
+            return ::operator new(size);
+        }
+
+        auto& free_list = pool.free_lists[index];
+        if (free_list.head)
+        {
+            ++pool.stats.recycled;
+            --free_list.size;
+            auto* head = free_list.head;
+            free_list.head = head->next;
+            head->~node();
+            return head;
+        }
+
+        return ::operator new(class_size(index));
+    }
+
+    static void deallocate(void* pointer, std::size_t size) noexcept
+    {
+        auto& pool = thread_pool();
+        ++pool.stats.deallocations;
+
+        auto const index = class_of(size);
+        if (index == class_count)
+        {
+            ::operator delete(pointer, size);
+            return;
+        }
+
+        auto& free_list = pool.free_lists[index];
+        if (free_list.size == max_cached)
+        {
+            ::operator delete(pointer, class_size(index));
+            return;
+        }
+
+        ++pool.stats.cached;
+        ++free_list.size;
+        free_list.head = ::new (pointer) node {free_list.head};
+    }
+
+    [[nodiscard]] static statistics const& thread_statistics() noexcept
+    {
+        return thread_pool().stats;
+    }
+
+private:
+    struct node
+    {
+        node* next;
+    };
+
+    struct free_list
+    {
+        node* head = nullptr;
+        std::size_t size = 0;
+    };
+
+    struct pool
+    {
+        pool() = default;
+        pool(pool const&) = delete;
+        pool& operator=(pool const&) = delete;
+
+        ~pool()
+        {
+            for (std::size_t index = 0; index != class_count; ++index)
+            {
+                while (auto* head = free_lists[index].head)
+                {
+                    free_lists[index].head = head->next;
+                    ::operator delete(head, class_size(index));
+                }
+            }
+        }
+
+        std::array<free_list, class_count> free_lists;
+        statistics stats;
+    };
+
+    static constexpr std::size_t class_of(std::size_t size) noexcept
+    {
+        std::size_t index = 0;
+        while (index != class_count && class_size(index) < size)
+        {
+            ++index;
+        }
+
+        return index;
+    }
+
+    static constexpr std::size_t class_size(std::size_t index) noexcept
+    {
+        return min_size << index;
+    }
+
+    static pool& thread_pool() noexcept
+    {
+        thread_local pool instance;
+        return instance;
+    }
+};
+
+} // namespace boost::taar
+
+#endif // BOOST_TAAR_CORE_FRAME_ALLOCATOR_HPP
@@ -18,8 +18,8 @@ namespace detail {
 template<class T>
 class is_async_generator_impl
 {
-    template<typename U>
-    static std::true_type check(async_generator<U> const*);
+    template<typename U, typename ExecutorType>
+    static std::true_type check(async_generator<U, ExecutorType> const*);
     static std::false_type check(...);
 
 public:
@@ -37,8 +37,8 @@ concept is_async_generator = requires
 template <typename T>
 struct async_generator_value;
 
-template <typename T>
-struct async_generator_value<async_generator<T>>
+template <typename T, typename ExecutorType>
+struct async_generator_value<async_generator<T, ExecutorType>>
 {
     using type = T;
 };
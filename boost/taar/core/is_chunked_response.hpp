@@ -18,8 +18,8 @@ namespace detail {
 template<class T>
 class is_chunked_response_impl
 {
-    template<typename U>
-    static std::true_type check(chunked_response<U> const*);
+    template<typename U, typename ExecutorType>
+    static std::true_type check(chunked_response<U, ExecutorType> const*);
     static std::false_type check(...);
 
 public:
@@ -37,8 +37,8 @@ concept is_chunked_response = requires
 template <typename T>
 struct chunked_response_value;
 
-template <typename T>
-struct chunked_response_value<chunked_response<T>>
+template <typename T, typename ExecutorType>
+struct chunked_response_value<chunked_response<T, ExecutorType>>
 {
     using type = T;
 };
@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_CORE_QUERY_PARAMS_HPP
+#define BOOST_TAAR_CORE_QUERY_PARAMS_HPP
+
+#include <boost/url/params_view.hpp>
+#include <boost/url/ignore_case.hpp>
+#include <boost/url/grammar/ci_string.hpp>
+#include <memory_resource>
+#include <unordered_map>
+#include <functional>
+#include <string_view>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+namespace boost::taar {
+namespace detail {
+
+struct query_key_hash
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view key) const noexcept
+    {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+} // namespace detail
+
+// Decoded query params of a request target, indexed by their key. Each key
+// keeps the value of its first occurrence and the number of its occurrences,
+// so the lookups and the ambiguity checks don't need to scan the query. The
+// keys and values are allocated from the specified memory resource, e.g. the
+// request arena of the session.
+class query_params
+{
+public:
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    struct param
+    {
+        using allocator_type = query_params::allocator_type;
+
+        param() = default;
+        param(param const&) = default;
+        param(param&&) = default;
+        param& operator=(param const&) = default;
+        param& operator=(param&&) = default;
+
+        explicit param(allocator_type allocator)
+            : value {allocator}
+        {}
+
+        param(param const& other, allocator_type allocator)
+            : value {other.value, allocator}
+            , count {other.count}
+            , position {other.position}
+        {}
+
+        param(param&& other, allocator_type allocator)
+            : value {std::move(other.value), allocator}
+            , count {other.count}
+            , position {other.position}
+        {}
+
+        std::pmr::string value;
+        size_type count = 0;
+        size_type position = 0;
+    };
+
+    query_params() = default;
+
+    explicit query_params(
+            boost::urls::params_view params,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : items_ {resource}
+    {
+        size_type position = 0;
+        for (auto const& item : params)
+        {
+            auto [iter, inserted] = items_.try_emplace(
+                std::pmr::string {item.key, resource});
+            if (inserted)
+            {
+                iter->second.value.assign(item.value);
+                iter->second.position = position;
+            }
+            ++iter->second.count;
+            ++position;
+        }
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return items_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return items_.empty();
+    }
+
+    // The first occurrence of the key or null if the key doesn't exist.
+    [[nodiscard]] param const* find(
+        std::string_view key,
+        boost::urls::ignore_case_param ic = {}) const
+    {
+        if (!ic)
+        {
+            auto const iter = items_.find(key);
+            return iter != items_.end() ? &iter->second : nullptr;
+        }
+
+        param const* result = nullptr;
+        for (auto const& [item_key, item] : items_)
+        {
+            if (boost::urls::grammar::ci_is_equal(item_key, key) &&
+                (!result || item.position < result->position))
+            {
+                result = &item;
+            }
+        }
+
+        return result;
+    }
+
+    // Number of occurrences of the key.
+    [[nodiscard]] size_type count(
+        std::string_view key,
+        boost::urls::ignore_case_param ic = {}) const
+    {
+        if (!ic)
+        {
+            auto const iter = items_.find(key);
+            return iter != items_.end() ? iter->second.count : 0;
+        }
+
+        size_type result = 0;
+        for (auto const& [item_key, item] : items_)
+        {
+            if (boost::urls::grammar::ci_is_equal(item_key, key))
+            {
+                result += item.count;
+            }
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] bool contains(
+        std::string_view key,
+        boost::urls::ignore_case_param ic = {}) const
+    {
+        return find(key, ic) != nullptr;
+    }
+
+private:
+    std::pmr::unordered_map<
+        std::pmr::string,
+        param,
+        detail::query_key_hash,
+        std::equal_to<>> items_;
+};
+
+} // namespace boost::taar
+
+#endif // BOOST_TAAR_CORE_QUERY_PARAMS_HPP
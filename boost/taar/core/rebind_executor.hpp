@@ -10,20 +10,18 @@
 #ifndef BOOST_TAAR_CORE_REBIND_EXECUTOR_HPP
 #define BOOST_TAAR_CORE_REBIND_EXECUTOR_HPP
 
-#include <boost/asio/io_context.hpp>
+#include <boost/taar/core/awaitable.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/as_tuple.hpp>
 
 namespace boost::taar {
 
-template <typename T>
+template <typename T, typename ExecutorType = default_executor>
 using rebind_executor = typename T::template
     rebind_executor<
-        boost::asio::as_tuple_t<
-            boost::asio::use_awaitable_t<
-                boost::asio::io_context::executor_type
-            >
-        >::executor_with_default<boost::asio::io_context::executor_type>
+        typename boost::asio::as_tuple_t<
+            boost::asio::use_awaitable_t<ExecutorType>
+        >::template executor_with_default<ExecutorType>
     >::other;
 
 } // namespace boost::taar
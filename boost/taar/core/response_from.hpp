@@ -209,13 +209,19 @@ inline constexpr auto response_from(T&&... value)
 template <has_response_from... T>
 using response_from_t = std::invoke_result_t<decltype(response_from<T...>), T...>;
 
+// The response_from_invoke overloads return an awaitable of the executor type
+// of the caller. An awaitable returned by the callable must use the same one.
+
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     std::is_void_v<std::invoke_result_t<CallableType, ArgsType...>>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
-awaitable<response_from_t<>>
+awaitable<response_from_t<>, ExecutorType>
 {
     std::invoke(
         std::forward<CallableType>(callable),
@@ -224,7 +230,10 @@ awaitable<response_from_t<>>
 }
 
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     has_response_from<std::invoke_result_t<CallableType, ArgsType...>> &&
     !is_async_generator<std::invoke_result_t<CallableType, ArgsType...>> &&
     !is_chunked_response<std::invoke_result_t<CallableType, ArgsType...>>)
@@ -232,7 +241,8 @@ inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
 awaitable<
-    response_from_t<typename std::invoke_result_t<CallableType, ArgsType...>>>
+    response_from_t<typename std::invoke_result_t<CallableType, ArgsType...>>,
+    ExecutorType>
 {
     co_return response_from(std::invoke(
         std::forward<CallableType>(callable),
@@ -240,14 +250,18 @@ awaitable<
 }
 
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_awaitable<std::invoke_result_t<CallableType, ArgsType...>> &&
     std::is_void_v<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
 awaitable<
-    response_from_t<>>
+    response_from_t<>,
+    ExecutorType>
 {
     co_await std::invoke(
         std::forward<CallableType>(callable),
@@ -256,7 +270,10 @@ awaitable<
 }
 
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_awaitable<std::invoke_result_t<CallableType, ArgsType...>> &&
     has_response_from<typename std::invoke_result_t<CallableType, ArgsType...>::value_type> &&
     !is_async_generator<typename std::invoke_result_t<CallableType, ArgsType...>::value_type> &&
@@ -265,7 +282,8 @@ inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
 awaitable<
-    response_from_t<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>>
+    response_from_t<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>,
+    ExecutorType>
 {
     co_return response_from(co_await std::invoke(
         std::forward<CallableType>(callable),
@@ -274,12 +292,15 @@ awaitable<
 
 // Sync handler returning async_generator<T>
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_async_generator<std::invoke_result_t<CallableType, ArgsType...>>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
-awaitable<std::invoke_result_t<CallableType, ArgsType...>>
+awaitable<std::invoke_result_t<CallableType, ArgsType...>, ExecutorType>
 {
     co_return std::invoke(
         std::forward<CallableType>(callable),
@@ -288,12 +309,15 @@ awaitable<std::invoke_result_t<CallableType, ArgsType...>>
 
 // Sync handler returning chunked_response<T>
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_chunked_response<std::invoke_result_t<CallableType, ArgsType...>>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
-awaitable<std::invoke_result_t<CallableType, ArgsType...>>
+awaitable<std::invoke_result_t<CallableType, ArgsType...>, ExecutorType>
 {
     co_return std::invoke(
         std::forward<CallableType>(callable),
@@ -302,13 +326,16 @@ awaitable<std::invoke_result_t<CallableType, ArgsType...>>
 
 // Async handler returning awaitable<async_generator<T>>
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_awaitable<std::invoke_result_t<CallableType, ArgsType...>> &&
     is_async_generator<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
-awaitable<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>
+awaitable<typename std::invoke_result_t<CallableType, ArgsType...>::value_type, ExecutorType>
 {
     co_return co_await std::invoke(
         std::forward<CallableType>(callable),
@@ -317,13 +344,16 @@ awaitable<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>
 
 // Async handler returning awaitable<chunked_response<T>>
 // response_from_invoke is always awaited for, so forwarding args is okay.
-template <typename CallableType, typename... ArgsType> requires (
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgsType> requires (
     is_awaitable<std::invoke_result_t<CallableType, ArgsType...>> &&
     is_chunked_response<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>)
 inline auto response_from_invoke(
     CallableType&& callable,
     ArgsType&&... args) ->
-awaitable<typename std::invoke_result_t<CallableType, ArgsType...>::value_type>
+awaitable<typename std::invoke_result_t<CallableType, ArgsType...>::value_type, ExecutorType>
 {
     co_return co_await std::invoke(
         std::forward<CallableType>(callable),
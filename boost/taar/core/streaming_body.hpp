@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_CORE_STREAMING_BODY_HPP
+#define BOOST_TAAR_CORE_STREAMING_BODY_HPP
+
+#include <boost/taar/core/async_generator.hpp>
+#include <span>
+#include <cstddef>
+
+namespace boost::taar {
+
+// Request body which is streamed to the handler while it's read from the
+// connection, so the body never has to fit in memory. The handler takes the
+// request by non-const reference and pulls the chunks from its body:
+//
+//   while (true)
+//   {
+//       auto [ec, chunk] = co_await request.body().next();
+//       if (!chunk)
+//           break;
+//       ...
+//   }
+//
+// The next chunk is only read from the socket when it's requested, and each
+// chunk is only valid until then. The generator runs on the executor of the
+// session.
+template <typename ExecutorType = default_executor>
+struct basic_streaming_body
+{
+    using chunk_type = std::span<std::byte const>;
+    using value_type = async_generator<chunk_type, ExecutorType>;
+
+    // Max size of each chunk.
+    static constexpr std::size_t chunk_size = 16 * 1024;
+};
+
+using streaming_body = basic_streaming_body<>;
+
+} // namespace boost::taar
+
+#endif // BOOST_TAAR_CORE_STREAMING_BODY_HPP
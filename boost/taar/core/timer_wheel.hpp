@@ -0,0 +1,305 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_CORE_TIMER_WHEEL_HPP
+#define BOOST_TAAR_CORE_TIMER_WHEEL_HPP
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/detail/concurrency_hint.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+#include <functional>
+#include <array>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace boost::taar {
+namespace detail {
+
+// Node of an intrusive circular list with a sentinel, so a node can unlink
+// itself without knowing its list.
+struct wheel_node
+{
+    wheel_node* prev = this;
+    wheel_node* next = this;
+
+    wheel_node() = default;
+    wheel_node(wheel_node const&) = delete;
+    wheel_node& operator=(wheel_node const&) = delete;
+
+    [[nodiscard]] bool linked() const noexcept
+    {
+        return next != this;
+    }
+
+    void unlink() noexcept
+    {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+    }
+
+    void push_back(wheel_node& node) noexcept
+    {
+        node.prev = prev;
+        node.next = this;
+        prev->next = &node;
+        prev = &node;
+    }
+
+    // Moves all the nodes of the list to the other list.
+    void splice_to(wheel_node& other) noexcept
+    {
+        while (linked())
+        {
+            auto& node = *next;
+            node.unlink();
+            other.push_back(node);
+        }
+    }
+};
+
+} // namespace detail
+
+// Hashed timer wheel with a coarse granularity. Arming, rearming and
+// cancelling a deadline cost O(1) no matter how many deadlines are armed, and
+// the wheel needs a single steady_timer which only ticks while any deadline is
+// armed. Deadlines never expire before their timeout and at most one tick
+// after it. The wheel and its entries must only be used from the thread
+// running the executor.
+class timer_wheel
+{
+public:
+    using clock = std::chrono::steady_clock;
+    using duration = clock::duration;
+    using executor_type = boost::asio::io_context::executor_type;
+
+    static constexpr duration default_tick = std::chrono::milliseconds {500};
+    static constexpr std::size_t slot_count = 512;
+
+    // Deadline which calls its handler when it expires. The entry is
+    // cancelled when it is destroyed.
+    class entry : private detail::wheel_node
+    {
+    public:
+        explicit entry(std::move_only_function<void()> on_expire)
+            : on_expire_ {std::move(on_expire)}
+        {}
+
+        ~entry()
+        {
+            cancel();
+        }
+
+        [[nodiscard]] bool armed() const noexcept
+        {
+            return linked();
+        }
+
+        void cancel() noexcept
+        {
+            if (linked())
+            {
+                unlink();
+                --wheel_->armed_count_;
+            }
+        }
+
+    private:
+        friend class timer_wheel;
+
+        std::move_only_function<void()> on_expire_;
+        timer_wheel* wheel_ = nullptr;
+        std::size_t rounds_ = 0;
+    };
+
+    explicit timer_wheel(executor_type executor, duration tick = default_tick)
+        : timer_ {executor}
+        , tick_ {tick}
+    {}
+
+    timer_wheel(timer_wheel const&) = delete;
+    timer_wheel& operator=(timer_wheel const&) = delete;
+
+    ~timer_wheel()
+    {
+        for (auto& slot : slots_)
+        {
+            while (slot.linked())
+            {
+                slot.next->unlink();
+            }
+        }
+    }
+
+    [[nodiscard]] duration tick() const noexcept
+    {
+        return tick_;
+    }
+
+    // Number of armed entries.
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return armed_count_;
+    }
+
+    // Arms or rearms the entry to expire after the timeout.
+    void arm(entry& e, duration timeout)
+    {
+        e.cancel();
+
+        auto ticks = timeout <= tick_ ? 1 : static_cast<std::size_t>(
+            (timeout + tick_ - duration {1}) / tick_);
+
+        // The next tick of a running wheel is less than a tick away, so it
+        // doesn't count towards the timeout.
+        if (ticking_)
+        {
+            ++ticks;
+        }
+
+        e.wheel_ = this;
+        e.rounds_ = (ticks - 1) / slot_count;
+        slots_[(cursor_ + ticks) % slot_count].push_back(e);
+        ++armed_count_;
+
+        // The wheel keeps ticking until a tick finds nothing armed, so
+        // rearming the only armed entry doesn't restart the timer.
+        if (!ticking_)
+        {
+            ticking_ = true;
+            next_tick_ = clock::now();
+            start();
+        }
+    }
+
+private:
+    void start()
+    {
+        // Ticks are scheduled at fixed points so the wheel doesn't drift.
+        next_tick_ += tick_;
+        timer_.expires_at(next_tick_);
+        timer_.async_wait([this](boost::system::error_code ec)
+        {
+            if (!ec)
+            {
+                advance();
+            }
+        });
+    }
+
+    void advance()
+    {
+        cursor_ = (cursor_ + 1) % slot_count;
+
+        // The due entries are detached first so a handler can rearm any entry
+        // without it being visited again in this tick.
+        detail::wheel_node due;
+        slots_[cursor_].splice_to(due);
+        while (due.linked())
+        {
+            auto& e = static_cast<entry&>(*due.next);
+            e.unlink();
+            if (e.rounds_ != 0)
+            {
+                --e.rounds_;
+                slots_[cursor_].push_back(e);
+                continue;
+            }
+
+            --armed_count_;
+            e.on_expire_();
+        }
+
+        if (armed_count_ != 0)
+        {
+            start();
+        }
+        else
+        {
+            ticking_ = false;
+        }
+    }
+
+    boost::asio::steady_timer timer_;
+    duration tick_;
+    clock::time_point next_tick_;
+    std::size_t cursor_ = 0;
+    std::size_t armed_count_ = 0;
+    bool ticking_ = false;
+    std::array<detail::wheel_node, slot_count> slots_;
+};
+
+// Timer wheel shared by everything running on an io_context.
+//   auto& wheel = boost::asio::use_service<timer_wheel_service>(io_context).wheel();
+class timer_wheel_service : public boost::asio::execution_context::service
+{
+public:
+    static inline boost::asio::execution_context::id id;
+
+    explicit timer_wheel_service(boost::asio::io_context& io_context)
+        : boost::asio::execution_context::service {io_context}
+        , wheel_ {io_context.get_executor()}
+    {}
+
+    [[nodiscard]] timer_wheel& wheel() noexcept
+    {
+        return wheel_;
+    }
+
+private:
+    void shutdown() override
+    {}
+
+    timer_wheel wheel_;
+};
+
+// The timer wheel of the io_context of the executor, or null if the io_context
+// may be run by several threads, as the wheel isn't synchronized. An
+// io_context is single threaded when it's created with a concurrency hint of 1
+// or with a hint which disables the locking of its scheduler. Strands are
+// looked through, but a strand doesn't make the wheel of a multi-threaded
+// io_context safe as the wheel is shared by all the strands.
+inline timer_wheel* find_timer_wheel(boost::asio::io_context& io_context)
+{
+    auto const hint = boost::asio::use_service<
+        boost::asio::detail::io_context_impl>(io_context).concurrency_hint();
+    if (hint != 1 && BOOST_ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER, hint))
+    {
+        return nullptr;
+    }
+
+    return &boost::asio::use_service<timer_wheel_service>(io_context).wheel();
+}
+
+template <typename ExecutorType>
+timer_wheel* find_timer_wheel(ExecutorType const& executor)
+{
+    if constexpr (std::is_convertible_v<
+        ExecutorType,
+        boost::asio::io_context::executor_type>)
+    {
+        return find_timer_wheel(executor.context());
+    }
+    else if constexpr (requires { executor.get_inner_executor(); })
+    {
+        return find_timer_wheel(executor.get_inner_executor());
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+} // namespace boost::taar
+
+#endif // BOOST_TAAR_CORE_TIMER_WHEEL_HPP
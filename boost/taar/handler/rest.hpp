@@ -64,6 +64,7 @@ template <typename... T>
 using common_requests_type_t = typename common_requests_type<T...>::type;
 
 template <
+    typename ExecutorType,
     typename CallableType,
     std::size_t... Indexes,
     typename... ArgProvidersType>
@@ -86,7 +87,7 @@ inline auto rest_for_callable(
         callable = std::forward<CallableType>(callable),
         ...arg_providers = std::move(arg_providers)
     ](request_type const& request, matcher::context const& context) mutable ->
-        decltype(response_from_invoke(
+        decltype(response_from_invoke<ExecutorType>(
             callable,
             get_rest_arg<
                 type_traits::callable_arg<noref_fn_type, Indexes>,
@@ -94,7 +95,7 @@ inline auto rest_for_callable(
             > (arg_providers, Indexes, request, context)...
         ))
     {
-        co_return co_await response_from_invoke(
+        co_return co_await response_from_invoke<ExecutorType>(
             callable,
             get_rest_arg<
                 type_traits::callable_arg<noref_fn_type, Indexes>,
@@ -105,6 +106,7 @@ inline auto rest_for_callable(
 }
 
 template <
+    typename ExecutorType,
     typename MemFnType,
     typename ObjectType,
     std::size_t... Indexes,
@@ -130,7 +132,7 @@ inline auto rest_for_memfn(
         object = std::forward<ObjectType>(object),
         ...arg_providers = std::move(arg_providers)
     ](request_type const& request, matcher::context const& context) mutable ->
-        decltype(response_from_invoke(
+        decltype(response_from_invoke<ExecutorType>(
             memfn,
             std::forward<ObjectType>(object),
             get_rest_arg<
@@ -139,7 +141,7 @@ inline auto rest_for_memfn(
             > (arg_providers, Indexes, request, context)...
         ))
     {
-        co_return co_await response_from_invoke(
+        co_return co_await response_from_invoke<ExecutorType>(
             memfn,
             std::forward<ObjectType>(object),
             get_rest_arg<
@@ -152,26 +154,35 @@ inline auto rest_for_memfn(
 
 } // namespace detail
 
-template <typename CallableType, typename... ArgProvidersType>
+// The handler returns an awaitable of the executor type of the session, e.g.
+// rest<strand_type>(...) for a session::basic_http<strand_type>.
+template <
+    typename ExecutorType = default_executor,
+    typename CallableType,
+    typename... ArgProvidersType>
 requires (!std::is_member_function_pointer_v<std::remove_cvref_t<CallableType>>)
 inline decltype(auto) rest(
     CallableType&& callable,
     ArgProvidersType... arg_providers)
 {
-    return detail::rest_for_callable(
+    return detail::rest_for_callable<ExecutorType>(
         std::forward<CallableType>(callable),
         std::index_sequence_for<ArgProvidersType...>{},
         std::move(arg_providers)...);
 }
 
-template <typename MemFnType, typename ObjectType, typename... ArgProvidersType>
+template <
+    typename ExecutorType = default_executor,
+    typename MemFnType,
+    typename ObjectType,
+    typename... ArgProvidersType>
 requires (member_function_of<MemFnType, std::remove_cvref_t<ObjectType>>)
 inline decltype(auto) rest(
     MemFnType memfn,
     ObjectType&& object,
     ArgProvidersType... arg_providers)
 {
-    return detail::rest_for_memfn(
+    return detail::rest_for_memfn<ExecutorType>(
         memfn,
         std::forward<ObjectType>(object),
         std::index_sequence_for<ArgProvidersType...>{},
@@ -20,6 +20,7 @@
 #include <boost/taar/type_traits/always_false.hpp>
 #include <boost/taar/type_traits/specialization_of.hpp>
 #include <boost/taar/type_traits/string_like.hpp>
+#include <boost/taar/type_traits/numeric_type.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/field.hpp>
@@ -31,13 +32,17 @@
 #include <boost/json/value_to.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/system/result.hpp>
+#include <boost/uuid/uuid.hpp>
 #include <functional>
 #include <system_error>
 #include <unordered_set>
 #include <variant>
 #include <optional>
 #include <format>
+#include <string_view>
 #include <string>
+#include <cstdint>
+#include <limits>
 #include <algorithm>
 #include <utility>
 #include <type_traits>
@@ -252,6 +257,56 @@ auto get_rest_arg(
     }
 }
 
+// Value of a path arg. Typed params, e.g. {id:u64}, carry the value converted
+// while matching the target so it is not parsed again.
+struct path_arg_value
+{
+    std::string_view text;
+    matcher::param_value typed;
+
+    template <typename ToType> requires rest_arg_castable<std::string_view, ToType>
+    friend auto tag_invoke(
+        detail::rest_arg_cast_built_in_tag<ToType>,
+        path_arg_value const& from)
+        -> rest_arg_cast_result_t<ToType, std::string_view>
+    {
+        if constexpr (type_traits::numeric_type<ToType>)
+        {
+            auto const fits = [](auto value)
+            {
+                // Unary plus promotes the character types for comparison.
+                if constexpr (std::is_integral_v<ToType>)
+                    return
+                        std::cmp_greater_equal(value, +std::numeric_limits<ToType>::min()) &&
+                        std::cmp_less_equal(value, +std::numeric_limits<ToType>::max());
+                else
+                    return true;
+            };
+
+            if (auto const* value = std::get_if<std::uint64_t>(&from.typed);
+                value && fits(*value))
+            {
+                return static_cast<ToType>(*value);
+            }
+
+            if (auto const* value = std::get_if<std::int64_t>(&from.typed);
+                value && fits(*value))
+            {
+                return static_cast<ToType>(*value);
+            }
+        }
+        else if constexpr (std::same_as<ToType, boost::uuids::uuid>)
+        {
+            if (auto const* value = std::get_if<boost::uuids::uuid>(&from.typed))
+            {
+                return *value;
+            }
+        }
+
+        return rest_arg_cast<ToType>(from.text);
+    }
+};
+
 // REST arg provider from the request path
 struct path_arg
 {
@@ -264,14 +319,15 @@ struct path_arg
         return path_key_;
     }
 
-    boost::system::result<std::string> operator()(
+    // The value refers to the request target or the context.
+    boost::system::result<path_arg_value> operator()(
         boost::beast::http::request_header<> const&,
         matcher::context const& context) const
     {
         auto iter = context.path_args.find(path_key_);
         if (iter != context.path_args.end())
         {
-            return std::string {iter->second};
+            return path_arg_value {context.path_args.value(*iter), iter->typed()};
         }
         return error::argument_not_found;
     }
@@ -294,28 +350,28 @@ struct query_arg
         return query_key_;
     }
 
+    // The query params are parsed once per request and shared by all the
+    // query args through the context.
     boost::system::result<std::string> operator()(
         boost::beast::http::request_header<> const& request,
-        matcher::context const&) const
+        matcher::context const& context) const
     {
-        auto url_view = boost::urls::parse_origin_form(request.target());
-        if (!url_view)
+        auto const& params = context.cache.parsed_query(
+            request,
+            context.memory_resource);
+        if (!params)
         {
-            return error::invalid_url_format;
+            return params.error();
         }
 
-        auto params = url_view->params();
-
-        if (params.count(query_key_, ic_) > 1)
+        if (params->count(query_key_, ic_) > 1)
         {
             return error::argument_ambiguous;
         }
 
-        auto iter = params.find(query_key_, ic_);
-        if (iter != params.end())
+        if (auto const* param = params->find(query_key_, ic_))
         {
-            auto const& param = *iter;
-            return std::string {param.value};
+            return std::string {param->value};
         }
         return error::argument_not_found;
     }
@@ -402,21 +458,19 @@ struct cookie_arg
         return name_;
     }
 
+    // The cookies are parsed once per request and shared with the cookie
+    // matchers and the other cookie args through the context.
     boost::system::result<std::string> operator()(
         boost::beast::http::request_header<> const& request,
-        matcher::context const&) const
+        matcher::context const& context) const
     {
-        cookies parsed_cookies;
-        auto r = request.equal_range(boost::beast::http::field::cookie);
-        for (; r.first != r.second; ++r.first)
-        {
-            parse_cookies(r.first->value(), parsed_cookies);
-        }
-
+        auto const& parsed_cookies = context.cache.parsed_cookies(
+            request,
+            context.memory_resource);
         auto const iter = parsed_cookies.find(name_);
         if (iter != parsed_cookies.end())
         {
-            return iter->second;
+            return std::string {parsed_cookies.value(*iter)};
         }
 
         return error::argument_not_found;
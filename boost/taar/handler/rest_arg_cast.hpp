@@ -11,14 +11,18 @@
 #define BOOST_TAAR_HANDLER_REST_ARG_CAST_HPP
 
 #include <boost/taar/handler/rest_arg_cast_tag.hpp>
+#include <boost/taar/matcher/param_type.hpp>
 #include <boost/taar/core/error.hpp>
 #include <boost/taar/type_traits/numeric_type.hpp>
 #include <boost/taar/type_traits/always_false.hpp>
 #include <boost/json/value.hpp>
 #include <boost/json/value_to.hpp>
+#include <boost/uuid/uuid.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/system/system_error.hpp>
 #include <utility>
+#include <string_view>
+#include <string>
 #include <charconv>
 #include <concepts>
 #include <type_traits>
@@ -110,6 +114,23 @@ inline ToType tag_invoke(rest_arg_cast_built_in_tag<ToType>, std::string_view fr
     return from_chars_conversion<ToType>(from.data(), from.size());
 }
 
+// From a string-like type to a UUID in its canonical form. Throw on any other
+// value.
+inline boost::uuids::uuid tag_invoke(
+    rest_arg_cast_built_in_tag<boost::uuids::uuid>,
+    std::string_view from)
+{
+    auto const result = matcher::parse_uuid(from);
+    if (!result)
+    {
+        throw boost::system::system_error {
+            error::invalid_uuid_format,
+            "REST arg cast from string to UUID error"};
+    }
+
+    return *result;
+}
+
 // From a numeric type to std::string: use std::to_chars and throw on error. The
 // buffer size is initially set to 4 times the size of the numeric type (which is
 // enough for any base, including binary), and doubled on each retry if the number
@@ -178,6 +199,27 @@ inline std::string tag_invoke(rest_arg_cast_built_in_tag<char const*>, std::stri
     return from;
 }
 
+// Safe-form casts from a string view. Templates are used to only accept an
+// actual string view and not anything convertible to it.
+template <std::same_as<std::string_view> FromType>
+inline std::string tag_invoke(rest_arg_cast_built_in_tag<std::string_view>, FromType from)
+{
+    return std::string {from};
+}
+
+template <std::same_as<std::string_view> FromType>
+inline std::string tag_invoke(rest_arg_cast_built_in_tag<char const*>, FromType from)
+{
+    return std::string {from};
+}
+
+// From a string view to std::string.
+template <std::same_as<std::string_view> FromType>
+inline std::string tag_invoke(rest_arg_cast_built_in_tag<std::string>, FromType from)
+{
+    return std::string {from};
+}
+
 // Check if there is a user-defined rest_arg_cast from FromType to ToType.
 template <typename FromType, typename ToType>
 concept has_user_defined_rest_arg_cast = requires (FromType const& from)
@@ -185,6 +227,14 @@ concept has_user_defined_rest_arg_cast = requires (FromType const& from)
     tag_invoke(rest_arg_cast_tag<ToType>{}, from);
 };
 
+// Check if there is a user-defined rest_arg_cast from std::string to ToType
+// which can be used for a string view (e.g. args referring to the request).
+template <typename FromType, typename ToType>
+concept has_user_defined_rest_arg_cast_from_string =
+    std::same_as<FromType, std::string_view> &&
+    !has_user_defined_rest_arg_cast<FromType, ToType> &&
+    has_user_defined_rest_arg_cast<std::string, ToType>;
+
 // Check if there is a built-in rest_arg_cast from FromType to ToType.
 template <typename FromType, typename ToType>
 concept has_built_in_rest_arg_cast = requires (FromType const& from)
@@ -199,6 +249,7 @@ concept has_built_in_rest_arg_cast = requires (FromType const& from)
 template <typename FromType, typename ToType>
 concept rest_arg_castable =
     detail::has_user_defined_rest_arg_cast<FromType, ToType> ||
+    detail::has_user_defined_rest_arg_cast_from_string<FromType, ToType> ||
     detail::has_built_in_rest_arg_cast<FromType, ToType>;
 
 // Cast a REST arg from FromType to ToType using either a user-defined or built-in
@@ -210,6 +261,10 @@ inline constexpr decltype(auto) rest_arg_cast(FromType const& from)
     {
         return tag_invoke(rest_arg_cast_tag<ToType>{}, from);
     }
+    else if constexpr (detail::has_user_defined_rest_arg_cast_from_string<FromType, ToType>)
+    {
+        return tag_invoke(rest_arg_cast_tag<ToType>{}, std::string {from});
+    }
     else if constexpr (detail::has_built_in_rest_arg_cast<FromType, ToType>)
     {
         return tag_invoke(detail::rest_arg_cast_built_in_tag<ToType>{}, from);
@@ -10,14 +10,556 @@
 #ifndef BOOST_TAAR_MATCHER_CONTEXT_HPP
 #define BOOST_TAAR_MATCHER_CONTEXT_HPP
 
-#include <unordered_map>
+#include <boost/taar/matcher/param_type.hpp>
+#include <boost/taar/core/cookies.hpp>
+#include <boost/taar/core/query_params.hpp>
+#include <boost/taar/core/error.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/url/pct_string_view.hpp>
+#include <boost/url/url_view.hpp>
+#include <boost/url/parse.hpp>
+#include <boost/system/result.hpp>
+#include <memory_resource>
+#include <initializer_list>
+#include <forward_list>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <string_view>
 #include <string>
+#include <utility>
+#include <vector>
+#include <array>
+#include <optional>
+#include <cstddef>
 
 namespace boost::taar::matcher {
 
+// A path arg captured by the target matcher. The value is kept as it appears in
+// the request target and is only percent-decoded the first time it is asked for.
+class path_arg_entry
+{
+public:
+    path_arg_entry() = default;
+
+    path_arg_entry(
+            std::string_view name,
+            std::string_view value,
+            bool encoded = false,
+            param_value typed = {})
+        : name_ {name}
+        , encoded_ {value}
+        , value_ {value}
+        , typed_ {std::move(typed)}
+        , pending_ {encoded}
+    {}
+
+    std::string const& name() const noexcept
+    {
+        return name_;
+    }
+
+    // The value as it appears in the request target.
+    std::string_view encoded() const noexcept
+    {
+        return encoded_;
+    }
+
+    // The converted value of a typed param, e.g. {id:u64}, or monostate.
+    param_value const& typed() const noexcept
+    {
+        return typed_;
+    }
+
+private:
+    friend class flat_path_args;
+
+    // The decoded value. Decoding happens on the first call, if needed at all,
+    // and the result is kept in the specified storage.
+    std::string_view value(std::pmr::forward_list<std::pmr::string>& storage) const
+    {
+        if (pending_)
+        {
+            pending_ = false;
+
+            auto const pct = boost::urls::make_pct_string_view(encoded_);
+            if (pct && pct->decoded_size() != pct->size())
+            {
+                auto const decoded = **pct;
+                value_ = storage.emplace_front(decoded.begin(), decoded.end());
+            }
+        }
+
+        return value_;
+    }
+
+    std::string name_;
+    std::string_view encoded_;
+    mutable std::string_view value_;
+    param_value typed_;
+    mutable bool pending_ = false;
+};
+
+// Flat storage of the path args captured by the target matcher. The values are
+// views into the request target. The ones that need percent-decoding are
+// decoded on demand and kept in the storage of the args. Up to inline_capacity
+// args are stored in place, so the common case needs no heap allocation as long
+// as the arg names fit in the small string buffer. The rest of the args and the
+// decoded values are allocated with the allocator of the args, e.g. from the
+// request memory of the session.
+class flat_path_args
+{
+public:
+    using value_type = path_arg_entry;
+    using const_iterator = value_type const*;
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    static constexpr size_type inline_capacity = 8;
+
+    flat_path_args() = default;
+
+    explicit flat_path_args(allocator_type allocator)
+        : overflow_ {allocator}
+        , decoded_ {allocator}
+    {}
+
+    flat_path_args(
+        std::initializer_list<std::pair<std::string_view, std::string_view>> args)
+    {
+        *this = args;
+    }
+
+    // Copies use the default memory resource, so they can outlive the request.
+    flat_path_args(flat_path_args const& other)
+    {
+        *this = other;
+    }
+
+    flat_path_args(flat_path_args&& other) noexcept
+        : inline_ {std::move(other.inline_)}
+        , overflow_ {std::move(other.overflow_)}
+        , decoded_ {std::move(other.decoded_)}
+        , size_ {std::exchange(other.size_, 0)}
+    {}
+
+    flat_path_args& operator=(flat_path_args const& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        clear();
+        for (auto const& arg : other)
+        {
+            emplace_entry(arg);
+        }
+
+        // Values referring to the storage of the other args must refer to
+        // the copies in this storage instead.
+        for (auto const& decoded : other.decoded_)
+        {
+            auto const& copy = decoded_.emplace_front(decoded);
+            for (auto iter = mutable_data(); iter != mutable_data() + size_; ++iter)
+            {
+                if (iter->value_.data() == decoded.data())
+                {
+                    iter->value_ = copy;
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    flat_path_args& operator=(flat_path_args&& other)
+    {
+        inline_ = std::move(other.inline_);
+        overflow_ = std::move(other.overflow_);
+        decoded_ = std::move(other.decoded_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    flat_path_args& operator=(
+        std::initializer_list<std::pair<std::string_view, std::string_view>> args)
+    {
+        clear();
+        for (auto const& [name, value] : args)
+        {
+            emplace(name, value);
+        }
+
+        return *this;
+    }
+
+    // Adds a path arg which refers to the specified value. Like the associative
+    // containers, an existing arg with the same name is not replaced.
+    bool emplace(std::string_view name, std::string_view value)
+    {
+        return emplace_entry(path_arg_entry {name, value});
+    }
+
+    // Adds a path arg which refers to the specified percent-encoded value and
+    // optionally its converted value.
+    bool emplace_encoded(
+        std::string_view name,
+        std::string_view value,
+        param_value typed = {})
+    {
+        return emplace_entry(path_arg_entry {name, value, true, std::move(typed)});
+    }
+
+    // Adds a path arg and keeps its value in the storage of the args.
+    bool emplace_owned(std::string_view name, std::string value)
+    {
+        if (contains(name))
+        {
+            return false;
+        }
+
+        return emplace(name, decoded_.emplace_front(std::move(value)));
+    }
+
+    const_iterator find(std::string_view name) const noexcept
+    {
+        return std::find_if(
+            begin(),
+            end(),
+            [name](value_type const& arg)
+            {
+                return arg.name() == name;
+            });
+    }
+
+    bool contains(std::string_view name) const noexcept
+    {
+        return find(name) != end();
+    }
+
+    // The decoded value of the path arg.
+    std::string_view at(std::string_view name) const
+    {
+        return value(*checked_find(name));
+    }
+
+    // The path arg as it appears in the request target.
+    std::string_view encoded(std::string_view name) const
+    {
+        return checked_find(name)->encoded();
+    }
+
+    // The decoded value of the path arg.
+    std::string_view value(value_type const& arg) const
+    {
+        return arg.value(decoded_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return size_ <= inline_capacity ? inline_.data() : overflow_.data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return begin() + size_;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return overflow_.get_allocator();
+    }
+
+    // Removes all the args and gives back their memory, so the memory resource
+    // of the args can be released afterwards.
+    void clear() noexcept
+    {
+        std::pmr::vector<value_type> {overflow_.get_allocator()}.swap(overflow_);
+        decoded_.clear();
+        size_ = 0;
+    }
+
+private:
+    value_type* mutable_data() noexcept
+    {
+        return size_ <= inline_capacity ? inline_.data() : overflow_.data();
+    }
+
+    const_iterator checked_find(std::string_view name) const
+    {
+        auto const iter = find(name);
+        if (iter == end())
+        {
+            throw std::out_of_range {"flat_path_args::at"};
+        }
+
+        return iter;
+    }
+
+    bool emplace_entry(path_arg_entry const& arg)
+    {
+        if (contains(arg.name_))
+        {
+            return false;
+        }
+
+        if (size_ < inline_capacity)
+        {
+            auto& entry = inline_[size_];
+            entry.name_.assign(arg.name_);
+            entry.encoded_ = arg.encoded_;
+            entry.value_ = arg.value_;
+            entry.typed_ = arg.typed_;
+            entry.pending_ = arg.pending_;
+        }
+        else
+        {
+            if (size_ == inline_capacity)
+            {
+                overflow_.assign(
+                    std::make_move_iterator(inline_.begin()),
+                    std::make_move_iterator(inline_.end()));
+            }
+            overflow_.push_back(arg);
+        }
+
+        ++size_;
+        return true;
+    }
+
+    std::array<value_type, inline_capacity> inline_;
+    std::pmr::vector<value_type> overflow_;
+    mutable std::pmr::forward_list<std::pmr::string> decoded_;
+    size_type size_ = 0;
+};
+
+// Values derived from the request which are only parsed the first time a
+// matcher or an arg provider asks for them, and then kept for the rest of the
+// request.
+class request_cache
+{
+public:
+    class scoped_values;
+
+    request_cache() = default;
+
+    request_cache(request_cache const& other)
+    {
+        *this = other;
+    }
+
+    request_cache& operator=(request_cache const& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            if (other.target_)
+            {
+                target_ = &target_storage_.emplace(*other.target_);
+            }
+
+            if (other.cookies_)
+            {
+                cookies_ = &cookies_storage_.emplace(*other.cookies_);
+            }
+
+            query_ = other.query_;
+            query_target_ = other.query_target_;
+        }
+
+        return *this;
+    }
+
+    // The parsed request target. Throws if the target is not a valid URI.
+    template <typename RequestType>
+    boost::urls::url_view const& parsed_target(RequestType const& request) const
+    {
+        if constexpr (requires { request.target(); })
+        {
+            auto const* parsed = find_parsed_target(request);
+            if (!parsed)
+            {
+                // Throws the parse error.
+                boost::urls::parse_uri_reference(request.target()).value();
+            }
+        }
+        else if (!target_)
+        {
+            target_ = &target_storage_.emplace();
+        }
+
+        return *target_;
+    }
+
+    // The parsed request target, or null if the target is not a valid URI.
+    template <typename RequestType>
+    boost::urls::url_view const* find_parsed_target(RequestType const& request) const
+    {
+        // The view is only reused while it refers to the same target.
+        std::string_view const target = request.target();
+        if (!target_ || (
+            target_storage_ &&
+            target_ == &*target_storage_ &&
+            target_->buffer().data() != target.data()))
+        {
+            auto const parsed = boost::urls::parse_uri_reference(target);
+            if (!parsed)
+            {
+                return nullptr;
+            }
+
+            target_ = &target_storage_.emplace(*parsed);
+        }
+
+        return target_;
+    }
+
+    // The cookies of all the Cookie headers of the request. The cookies refer
+    // to the headers of the request and are allocated from the resource when
+    // they are first parsed.
+    template <typename RequestType>
+    cookies_view const& parsed_cookies(
+        RequestType const& request,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        if (!cookies_)
+        {
+            // The storage is reused while it allocates from the same resource.
+            if (!cookies_storage_ || cookies_storage_->get_allocator().resource() != resource)
+            {
+                cookies_storage_.emplace(cookies_view::allocator_type {resource});
+            }
+
+            auto& result = *cookies_storage_;
+            result.clear();
+            if constexpr (requires { request.equal_range(boost::beast::http::field::cookie); })
+            {
+                auto r = request.equal_range(boost::beast::http::field::cookie);
+                for (; r.first != r.second; ++r.first)
+                {
+                    result.append(r.first->value());
+                }
+            }
+
+            cookies_ = &result;
+        }
+
+        return *cookies_;
+    }
+
+    // The query params of the request target, parsed and indexed in one pass.
+    // The params are allocated from the resource when they are first parsed.
+    template <typename RequestType>
+    boost::system::result<query_params> const& parsed_query(
+        RequestType const& request,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        std::string_view const target = request.target();
+        if (!query_ ||
+            query_target_.data() != target.data() ||
+            query_target_.size() != target.size())
+        {
+            auto const parsed = boost::urls::parse_origin_form(target);
+            if (parsed)
+            {
+                query_.emplace(query_params {parsed->params(), resource});
+            }
+            else
+            {
+                query_.emplace(error::invalid_url_format);
+            }
+            query_target_ = target;
+        }
+
+        return *query_;
+    }
+
+    // Uses the specified values instead of parsing the request until the
+    // returned object is destroyed.
+    [[nodiscard]] scoped_values use(
+        boost::urls::url_view const& parsed_target,
+        cookies_view const& parsed_cookies) const;
+
+    scoped_values use(
+        boost::urls::url_view const& parsed_target,
+        cookies_view&& parsed_cookies) const = delete;
+
+    // Forgets the parsed values, e.g. before the next request, and gives back
+    // the memory they were allocated from.
+    void clear() noexcept
+    {
+        target_ = nullptr;
+        cookies_ = nullptr;
+        query_.reset();
+        if (cookies_storage_)
+        {
+            cookies_storage_->clear();
+        }
+    }
+
+private:
+    mutable std::optional<boost::urls::url_view> target_storage_;
+    mutable std::optional<cookies_view> cookies_storage_;
+    mutable boost::urls::url_view const* target_ = nullptr;
+    mutable cookies_view const* cookies_ = nullptr;
+    mutable std::optional<boost::system::result<query_params>> query_;
+    mutable std::string_view query_target_;
+};
+
+class request_cache::scoped_values
+{
+public:
+    scoped_values(
+            request_cache const& cache,
+            boost::urls::url_view const& parsed_target,
+            cookies_view const& parsed_cookies)
+        : cache_ {cache}
+        , target_ {std::exchange(cache.target_, &parsed_target)}
+        , cookies_ {std::exchange(cache.cookies_, &parsed_cookies)}
+    {}
+
+    scoped_values(scoped_values const&) = delete;
+    scoped_values& operator=(scoped_values const&) = delete;
+
+    ~scoped_values()
+    {
+        cache_.target_ = target_;
+        cache_.cookies_ = cookies_;
+    }
+
+private:
+    request_cache const& cache_;
+    boost::urls::url_view const* target_;
+    cookies_view const* cookies_;
+};
+
+inline request_cache::scoped_values request_cache::use(
+    boost::urls::url_view const& parsed_target,
+    cookies_view const& parsed_cookies) const
+{
+    return scoped_values {*this, parsed_target, parsed_cookies};
+}
+
 struct context
 {
-    std::unordered_map<std::string, std::string> path_args;
+    flat_path_args path_args;
+    request_cache cache;
+
+    // Request-scoped memory. The session points it to an arena of the
+    // connection which is released when the request is done, so anything
+    // allocated from it must not outlive the request.
+    std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource();
 };
 
 } // namespace boost::taar::matcher
@@ -35,12 +35,12 @@ struct cookie_t
                 [lhs = std::move(lhs), rhs = std::move(rhs)](
                     request_type const&,
                     context&,
-                    cookies const& parsed_cookies)
+                    cookies_view const& parsed_cookies)
                 {
                     auto iter = parsed_cookies.find(lhs.name);
                     return
                         iter != parsed_cookies.end() &&
-                        iter->second == rhs;
+                        parsed_cookies.value(*iter) == rhs;
                 }
             };
         }
@@ -67,7 +67,7 @@ struct cookie_t
                 [cookie = std::move(cookie)](
                     request_type const&,
                     context&,
-                    cookies const& parsed_cookies)
+                    cookies_view const& parsed_cookies)
                 {
                     return parsed_cookies.contains(cookie.name);
                 }
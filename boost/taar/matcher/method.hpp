@@ -12,6 +12,8 @@
 
 #include <boost/taar/matcher/context.hpp>
 #include <boost/taar/matcher/operand.hpp>
+#include <boost/taar/matcher/route_hint.hpp>
+#include <boost/beast/http/verb.hpp>
 #include <boost/beast/http/message.hpp>
 
 namespace boost::taar::matcher {
@@ -23,6 +25,14 @@ struct method_t
 
     friend auto operator==(method_t, std::string verb)
     {
+        // Known methods are parsed into their verb, so the hint still holds.
+        route_hint hint;
+        if (auto const known_verb = boost::beast::http::string_to_verb(verb);
+            known_verb != boost::beast::http::verb::unknown)
+        {
+            hint.method = known_verb;
+        }
+
         return matcher::operand
         {
             [verb = std::move(verb)](
@@ -30,7 +40,8 @@ struct method_t
                 context& context)
             {
                 return request.method_string() == verb;
-            }
+            },
+            std::move(hint)
         };
     }
 
@@ -43,7 +54,8 @@ struct method_t
                 context& context)
             {
                 return request.method() == verb;
-            }
+            },
+            route_hint {.method = verb}
         };
     }
 
@@ -11,6 +11,7 @@
 #define BOOST_TAAR_MATCHER_MATCHER_HPP
 
 #include <boost/taar/matcher/context.hpp>
+#include <boost/taar/matcher/route_hint.hpp>
 #include <boost/taar/core/cookies.hpp>
 #include <boost/taar/matcher/detail/callable_with.hpp>
 #include <boost/taar/type_traits/specialization_of.hpp>
@@ -21,14 +22,40 @@
 #include <utility>
 
 namespace boost::taar::matcher {
+namespace detail {
+
+// Callable of a combined matcher. It evaluates the operands on demand, so the
+// parsed target and cookies are only needed if the operand that uses them is
+// actually evaluated.
+template <bool WithParsedTarget, bool WithParsedCookies, typename CallableType>
+struct combined_callable : CallableType
+{
+    static constexpr bool with_parsed_target = WithParsedTarget;
+    static constexpr bool with_parsed_cookies = WithParsedCookies;
+
+    explicit combined_callable(CallableType callable)
+        : CallableType {std::move(callable)}
+    {}
+
+    using CallableType::operator();
+};
+
+template <bool WithParsedTarget, bool WithParsedCookies, typename CallableType>
+auto make_combined_callable(CallableType callable)
+{
+    return combined_callable<WithParsedTarget, WithParsedCookies, CallableType> {
+        std::move(callable)};
+}
+
+} // namespace detail
 
 template <typename RequestType, typename CallableType>
 requires (
     detail::callable_with<CallableType, bool, RequestType const&, context&> ||
     detail::callable_with<CallableType, bool, RequestType const&, context&, boost::urls::url_view const&> ||
-    detail::callable_with<CallableType, bool, RequestType const&, context&, cookies const&> ||
-    detail::callable_with<CallableType, bool, RequestType const&, context&, boost::urls::url_view const&, cookies const&> ||
-    detail::callable_with<CallableType, bool, RequestType const&, context&, cookies const&, boost::urls::url_view const&>)
+    detail::callable_with<CallableType, bool, RequestType const&, context&, cookies_view const&> ||
+    detail::callable_with<CallableType, bool, RequestType const&, context&, boost::urls::url_view const&, cookies_view const&> ||
+    detail::callable_with<CallableType, bool, RequestType const&, context&, cookies_view const&, boost::urls::url_view const&>)
 class operand
 {
 public:
@@ -42,13 +69,13 @@ public:
             RequestType const&,
             context&,
             boost::urls::url_view const&,
-            cookies const&> ? 4 :
+            cookies_view const&> ? 4 :
         detail::callable_with<
             CallableType,
             bool,
             RequestType const&,
             context&,
-            cookies const&,
+            cookies_view const&,
             boost::urls::url_view const&> ? 3 :
         detail::callable_with<
             CallableType,
@@ -61,38 +88,58 @@ public:
             bool,
             RequestType const&,
             context&,
-            cookies const&> ? 1 : 0;
+            cookies_view const&> ? 1 : 0;
     static constexpr auto with_parsed_target =
-        callabe_kind == 4 || callabe_kind == 3 || callabe_kind == 2;
+        callabe_kind == 4 || callabe_kind == 3 || callabe_kind == 2 ||
+        requires { requires CallableType::with_parsed_target; };
     static constexpr auto with_parsed_cookies =
-        callabe_kind == 4 || callabe_kind == 3 || callabe_kind == 1;
+        callabe_kind == 4 || callabe_kind == 3 || callabe_kind == 1 ||
+        requires { requires CallableType::with_parsed_cookies; };
 
 public:
-    operand(callable_type callable)
+    operand(callable_type callable, route_hint hint = {})
     : callable_ {std::move(callable)}
+    , hint_ {std::move(hint)}
     {}
 
+    route_hint const& hint() const
+    {
+        return hint_;
+    }
+
+    // Evaluates the matcher. The parsed target and cookies are taken from the
+    // request cache of the context, so they are only parsed if the matcher
+    // actually needs them and at most once per request.
     auto operator()(
         request_type const& request,
-        context& context,
-        boost::urls::url_view const& parsed_target,
-        cookies const& parsed_cookies) const
+        context& context) const
     {
         if constexpr (callabe_kind == 4)
         {
-            return callable_(request, context, parsed_target, parsed_cookies);
+            return callable_(
+                request,
+                context,
+                context.cache.parsed_target(request),
+                context.cache.parsed_cookies(request, context.memory_resource));
         }
         else if constexpr (callabe_kind == 3)
         {
-            return callable_(request, context, parsed_cookies, parsed_target);
+            return callable_(
+                request,
+                context,
+                context.cache.parsed_cookies(request, context.memory_resource),
+                context.cache.parsed_target(request));
         }
         else if constexpr (callabe_kind == 2)
         {
-            return callable_(request, context, parsed_target);
+            return callable_(request, context, context.cache.parsed_target(request));
         }
         else if constexpr (callabe_kind == 1)
         {
-            return callable_(request, context, parsed_cookies);
+            return callable_(
+                request,
+                context,
+                context.cache.parsed_cookies(request, context.memory_resource));
         }
         else
         {
@@ -100,54 +147,46 @@ public:
         }
     }
 
-    friend auto operator!(operand opr)
+    // Evaluates the matcher with the specified parsed target and cookies.
+    auto operator()(
+        request_type const& request,
+        context& context,
+        boost::urls::url_view const& parsed_target,
+        cookies_view const& parsed_cookies) const
     {
-        if constexpr (with_parsed_target && with_parsed_cookies)
+        if constexpr (callabe_kind == 4)
         {
-            return matcher::operand {
-                [opr = std::move(opr)](
-                    request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target,
-                    cookies const& parsed_cookies)
-                {
-                    return !opr.operator()(request, context, parsed_target, parsed_cookies);
-                }
-            };
+            return callable_(request, context, parsed_target, parsed_cookies);
         }
-        else if constexpr (with_parsed_target)
+        else if constexpr (callabe_kind == 3)
         {
-            return matcher::operand {
-                [opr = std::move(opr)](
-                    request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target)
-                {
-                    return !opr.operator()(request, context, parsed_target, {});
-                }
-            };
+            return callable_(request, context, parsed_cookies, parsed_target);
         }
-        else if constexpr (with_parsed_cookies)
+        else if constexpr (callabe_kind == 2)
         {
-            return matcher::operand {
-                [opr = std::move(opr)](
-                    request_type const& request,
-                    context& context,
-                    cookies const& parsed_cookies)
-                {
-                    return !opr.operator()(request, context, {}, parsed_cookies);
-                }
-            };
+            return callable_(request, context, parsed_target);
+        }
+        else if constexpr (callabe_kind == 1)
+        {
+            return callable_(request, context, parsed_cookies);
         }
         else
         {
-            return matcher::operand {
+            // Combined matchers take them from the request cache.
+            auto const values = context.cache.use(parsed_target, parsed_cookies);
+            return callable_(request, context);
+        }
+    }
+
+    friend auto operator!(operand opr)
+    {
+        return matcher::operand {
+            detail::make_combined_callable<with_parsed_target, with_parsed_cookies>(
                 [opr = std::move(opr)](request_type const& request, context& context)
                 {
-                    return !opr.operator()(request, context, {}, {});
-                }
-            };
-        }
+                    return !opr(request, context);
+                })
+        };
     }
 
     template <typename RHSType>
@@ -157,73 +196,26 @@ public:
         RHSType&& rhs)
     {
         matcher::operand rhs_operand {std::forward<RHSType&&>(rhs)};
+        auto hint = lhs_operand.hint() && rhs_operand.hint();
         using rhs_operand_type = decltype(rhs_operand);
         using rhs_request_type = typename rhs_operand_type::request_type;
         using super_request_type = type_traits::super_type_t<request_type, rhs_request_type>;
 
-        constexpr auto with_target = with_parsed_target || rhs_operand_type::with_parsed_target;
-        constexpr auto with_cookie = with_parsed_cookies || rhs_operand_type::with_parsed_cookies;
-
-        if constexpr (with_target && with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, parsed_cookies) &&
-                        rhs_operand(request, context, parsed_target, parsed_cookies);
-                }
-            };
-        }
-        else if constexpr (with_target)
+        return matcher::operand
         {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, {}) &&
-                        rhs_operand(request, context, parsed_target, {});
-                }
-            };
-        }
-        else if constexpr (with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, {}, parsed_cookies) &&
-                        rhs_operand(request, context, {}, parsed_cookies);
-                }
-            };
-        }
-        else
-        {
-            return matcher::operand
-            {
+            detail::make_combined_callable<
+                with_parsed_target || rhs_operand_type::with_parsed_target,
+                with_parsed_cookies || rhs_operand_type::with_parsed_cookies>(
                 [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
                     super_request_type const& request,
                     context& context)
                 {
                     return
-                        lhs_operand(request, context, {}, {}) &&
-                        rhs_operand(request, context, {}, {});
-                }
-            };
-        }
+                        lhs_operand(request, context) &&
+                        rhs_operand(request, context);
+                }),
+            std::move(hint)
+        };
     }
 
     template <typename LHSType>
@@ -233,73 +225,26 @@ public:
         operand rhs_operand)
     {
         matcher::operand lhs_operand {std::forward<LHSType&&>(lhs)};
+        auto hint = lhs_operand.hint() && rhs_operand.hint();
         using lhs_operand_type = decltype(lhs_operand);
         using lhs_request_type = typename lhs_operand_type::request_type;
         using super_request_type = type_traits::super_type_t<request_type, lhs_request_type>;
 
-        constexpr auto with_target = with_parsed_target || lhs_operand_type::with_parsed_target;
-        constexpr auto with_cookie = with_parsed_cookies || lhs_operand_type::with_parsed_cookies;
-
-        if constexpr (with_target && with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, parsed_cookies) &&
-                        rhs_operand(request, context, parsed_target, parsed_cookies);
-                }
-            };
-        }
-        else if constexpr (with_target)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, {}) &&
-                        rhs_operand(request, context, parsed_target, {});
-                }
-            };
-        }
-        else if constexpr (with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, {}, parsed_cookies) &&
-                        rhs_operand(request, context, {}, parsed_cookies);
-                }
-            };
-        }
-        else
+        return matcher::operand
         {
-            return matcher::operand
-            {
+            detail::make_combined_callable<
+                with_parsed_target || lhs_operand_type::with_parsed_target,
+                with_parsed_cookies || lhs_operand_type::with_parsed_cookies>(
                 [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
                     super_request_type const& request,
                     context& context)
                 {
                     return
-                        lhs_operand(request, context, {}, {}) &&
-                        rhs_operand(request, context, {}, {});
-                }
-            };
-        }
+                        lhs_operand(request, context) &&
+                        rhs_operand(request, context);
+                }),
+            std::move(hint)
+        };
     }
 
     template <typename RHSType>
@@ -313,69 +258,20 @@ public:
         using rhs_request_type = typename rhs_operand_type::request_type;
         using super_request_type = type_traits::super_type_t<request_type, rhs_request_type>;
 
-        constexpr auto with_target = with_parsed_target || rhs_operand_type::with_parsed_target;
-        constexpr auto with_cookie = with_parsed_cookies || rhs_operand_type::with_parsed_cookies;
-
-        if constexpr (with_target && with_cookie)
+        return matcher::operand
         {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, parsed_cookies) ||
-                        rhs_operand(request, context, parsed_target, parsed_cookies);
-                }
-            };
-        }
-        else if constexpr (with_target)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, {}) ||
-                        rhs_operand(request, context, parsed_target, {});
-                }
-            };
-        }
-        else if constexpr (with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, {}, parsed_cookies) ||
-                        rhs_operand(request, context, {}, parsed_cookies);
-                }
-            };
-        }
-        else
-        {
-            return matcher::operand
-            {
+            detail::make_combined_callable<
+                with_parsed_target || rhs_operand_type::with_parsed_target,
+                with_parsed_cookies || rhs_operand_type::with_parsed_cookies>(
                 [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
                     super_request_type const& request,
                     context& context)
                 {
                     return
-                        lhs_operand(request, context, {}, {}) ||
-                        rhs_operand(request, context, {}, {});
-                }
-            };
-        }
+                        lhs_operand(request, context) ||
+                        rhs_operand(request, context);
+                })
+        };
     }
 
     template <typename LHSType>
@@ -389,73 +285,25 @@ public:
         using lhs_request_type = typename lhs_operand_type::request_type;
         using super_request_type = type_traits::super_type_t<request_type, lhs_request_type>;
 
-        constexpr auto with_target = with_parsed_target || lhs_operand_type::with_parsed_target;
-        constexpr auto with_cookie = with_parsed_cookies || lhs_operand_type::with_parsed_cookies;
-
-        if constexpr (with_target && with_cookie)
+        return matcher::operand
         {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, parsed_cookies) ||
-                        rhs_operand(request, context, parsed_target, parsed_cookies);
-                }
-            };
-        }
-        else if constexpr (with_target)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    boost::urls::url_view const& parsed_target)
-                {
-                    return
-                        lhs_operand(request, context, parsed_target, {}) ||
-                        rhs_operand(request, context, parsed_target, {});
-                }
-            };
-        }
-        else if constexpr (with_cookie)
-        {
-            return matcher::operand
-            {
-                [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
-                    super_request_type const& request,
-                    context& context,
-                    cookies const& parsed_cookies)
-                {
-                    return
-                        lhs_operand(request, context, {}, parsed_cookies) ||
-                        rhs_operand(request, context, {}, parsed_cookies);
-                }
-            };
-        }
-        else
-        {
-            return matcher::operand
-            {
+            detail::make_combined_callable<
+                with_parsed_target || lhs_operand_type::with_parsed_target,
+                with_parsed_cookies || lhs_operand_type::with_parsed_cookies>(
                 [lhs_operand = std::move(lhs_operand), rhs_operand = std::move(rhs_operand)](
                     super_request_type const& request,
                     context& context)
                 {
                     return
-                        lhs_operand(request, context, {}, {}) ||
-                        rhs_operand(request, context, {}, {});
-                }
-            };
-        }
+                        lhs_operand(request, context) ||
+                        rhs_operand(request, context);
+                })
+        };
     }
 
 private:
     callable_type callable_;
+    route_hint hint_;
 };
 
 template <typename ObjectType>
@@ -466,6 +314,14 @@ operand(ObjectType) ->
         >::template arg<0>
     >, ObjectType>;
 
+template <typename ObjectType>
+operand(ObjectType, route_hint) ->
+    operand<
+        std::remove_cvref_t<
+            typename type_traits::callable<std::remove_cvref_t<ObjectType>
+        >::template arg<0>
+    >, ObjectType>;
+
 template <typename MatcherType>
 concept is_matcher = requires(MatcherType&& matcher)
 {
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_MATCHER_PARAM_TYPE_HPP
+#define BOOST_TAAR_MATCHER_PARAM_TYPE_HPP
+
+#include <boost/uuid/uuid.hpp>
+#include <boost/url/pct_string_view.hpp>
+#include <variant>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <charconv>
+#include <cstdint>
+#include <cstddef>
+
+namespace boost::taar::matcher {
+
+// Type of a template path param, e.g. {id:u64}. Params without a type are
+// strings and match any segment.
+enum class template_param_type : char
+{
+    string,
+    u64,
+    i64,
+    uuid,
+};
+
+// Number of the param types other than string.
+inline constexpr std::size_t typed_param_count = 3;
+
+// Value of a typed path param which is converted while matching the target.
+using param_value = std::variant<
+    std::monostate,
+    std::uint64_t,
+    std::int64_t,
+    boost::uuids::uuid>;
+
+namespace detail {
+
+constexpr std::optional<template_param_type> param_type_from_name(
+    std::string_view name)
+{
+    if (name == "u64")
+    {
+        return template_param_type::u64;
+    }
+
+    if (name == "i64")
+    {
+        return template_param_type::i64;
+    }
+
+    if (name == "uuid")
+    {
+        return template_param_type::uuid;
+    }
+
+    return std::nullopt;
+}
+
+constexpr int hex_digit_value(char ch)
+{
+    if (ch >= '0' && ch <= '9')
+    {
+        return ch - '0';
+    }
+
+    if (ch >= 'a' && ch <= 'f')
+    {
+        return ch - 'a' + 10;
+    }
+
+    if (ch >= 'A' && ch <= 'F')
+    {
+        return ch - 'A' + 10;
+    }
+
+    return -1;
+}
+
+template <typename IntegerType>
+std::optional<IntegerType> parse_integer(std::string_view value)
+{
+    IntegerType result {};
+    auto const end = value.data() + value.size();
+    auto const [ptr, ec] = std::from_chars(value.data(), end, result);
+    if (value.empty() || ec != std::errc {} || ptr != end)
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+} // namespace detail
+
+// Parses a UUID in its canonical form, e.g. 123e4567-e89b-12d3-a456-426614174000
+inline std::optional<boost::uuids::uuid> parse_uuid(std::string_view value)
+{
+    if (value.size() != 36)
+    {
+        return std::nullopt;
+    }
+
+    boost::uuids::uuid result {};
+    std::size_t byte = 0;
+    for (std::size_t index = 0; index != value.size();)
+    {
+        if (index == 8 || index == 13 || index == 18 || index == 23)
+        {
+            if (value[index] != '-')
+            {
+                return std::nullopt;
+            }
+
+            ++index;
+            continue;
+        }
+
+        auto const high = detail::hex_digit_value(value[index]);
+        auto const low = detail::hex_digit_value(value[index + 1]);
+        if (high < 0 || low < 0)
+        {
+            return std::nullopt;
+        }
+
+        result.data[byte++] = static_cast<std::uint8_t>(high * 16 + low);
+        index += 2;
+    }
+
+    return result;
+}
+
+// Converts the decoded path param to the specified type. An empty optional is
+// returned if the value is not valid for the type.
+inline std::optional<param_value> parse_param(
+    template_param_type type,
+    std::string_view value)
+{
+    switch (type)
+    {
+    case template_param_type::string:
+        return param_value {};
+
+    case template_param_type::u64:
+        if (auto result = detail::parse_integer<std::uint64_t>(value))
+        {
+            return param_value {*result};
+        }
+        break;
+
+    case template_param_type::i64:
+        if (auto result = detail::parse_integer<std::int64_t>(value))
+        {
+            return param_value {*result};
+        }
+        break;
+
+    case template_param_type::uuid:
+        if (auto result = parse_uuid(value))
+        {
+            return param_value {*result};
+        }
+        break;
+    }
+
+    return std::nullopt;
+}
+
+namespace detail {
+
+// Converts the path param segment to the specified type, decoding it first if
+// needed.
+inline std::optional<param_value> parse_param(
+    template_param_type type,
+    boost::urls::pct_string_view segment)
+{
+    if (type == template_param_type::string)
+    {
+        return param_value {};
+    }
+
+    if (segment.decoded_size() == segment.size())
+    {
+        return matcher::parse_param(type, std::string_view {segment.data(), segment.size()});
+    }
+
+    auto const decoded = *segment;
+    return matcher::parse_param(type, std::string {decoded.begin(), decoded.end()});
+}
+
+} // namespace detail
+
+} // namespace boost::taar::matcher
+
+#endif // BOOST_TAAR_MATCHER_PARAM_TYPE_HPP
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_MATCHER_ROUTE_HINT_HPP
+#define BOOST_TAAR_MATCHER_ROUTE_HINT_HPP
+
+#include <boost/taar/matcher/template_parser.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <optional>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace boost::taar::matcher {
+
+// Static knowledge about the requests a matcher can accept. Every request
+// accepted by the matcher must also satisfy its hint which allows the session
+// to index the matchers and skip the ones that can't match a request. A hint is
+// only a necessary condition and the matcher itself still has the final word.
+struct route_hint
+{
+    // The segments of the target template that must match the request target.
+    // The segments of a route template are in static storage and the rest are
+    // kept alive by the target storage.
+    std::optional<std::span<template_segment_ref const>> target;
+    std::shared_ptr<void const> target_storage;
+
+    // The method that must match the request method.
+    std::optional<boost::beast::http::verb> method;
+
+    // Both sides of a conjunction must hold, so any of the hints is valid for
+    // the combined matcher.
+    friend route_hint operator&&(route_hint lhs, route_hint rhs)
+    {
+        if (!lhs.target)
+        {
+            lhs.target = rhs.target;
+            lhs.target_storage = std::move(rhs.target_storage);
+        }
+
+        if (!lhs.method)
+        {
+            lhs.method = rhs.method;
+        }
+
+        return lhs;
+    }
+};
+
+} // namespace boost::taar::matcher
+
+#endif // BOOST_TAAR_MATCHER_ROUTE_HINT_HPP
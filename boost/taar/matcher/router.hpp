@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_MATCHER_ROUTER_HPP
+#define BOOST_TAAR_MATCHER_ROUTER_HPP
+
+#include <boost/taar/matcher/route_hint.hpp>
+#include <boost/taar/matcher/template_parser.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/url/url_view.hpp>
+#include <boost/url/segments_encoded_view.hpp>
+#include <boost/url/pct_string_view.hpp>
+#include <unordered_map>
+#include <functional>
+#include <memory_resource>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace boost::taar::matcher {
+namespace detail {
+
+// Merges the sorted routes into the sorted candidates. A route which is already
+// a candidate, e.g. of a node reached again through a greedy param, is only
+// kept once.
+inline void merge_routes(
+    std::pmr::vector<std::size_t>& candidates,
+    std::span<std::size_t const> routes)
+{
+    if (routes.empty())
+    {
+        return;
+    }
+
+    if (candidates.empty() || candidates.back() < routes.front())
+    {
+        candidates.insert(candidates.end(), routes.begin(), routes.end());
+        return;
+    }
+
+    // Merged from the back, so the candidates are only moved once.
+    auto const size = candidates.size();
+    candidates.resize(size + routes.size());
+    auto candidates_end = candidates.begin() + size;
+    auto out = candidates.end();
+    auto routes_end = routes.end();
+    while (routes_end != routes.begin())
+    {
+        if (candidates_end != candidates.begin() &&
+            *std::prev(candidates_end) > *std::prev(routes_end))
+        {
+            *--out = *--candidates_end;
+            continue;
+        }
+
+        if (candidates_end != candidates.begin() &&
+            *std::prev(candidates_end) == *std::prev(routes_end))
+        {
+            --candidates_end;
+        }
+
+        *--out = *--routes_end;
+    }
+
+    out = std::move_backward(candidates.begin(), candidates_end, out);
+    candidates.erase(candidates.begin(), out);
+}
+
+struct segment_hash
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view segment) const noexcept
+    {
+        return std::hash<std::string_view>{}(segment);
+    }
+};
+
+// Segment trie of the routes. Routes with a target template in their hint are
+// kept in the trie so a lookup only costs as much as the depth of the request
+// target. The rest of the routes (e.g. arbitrary lambda matchers) are always
+// returned as candidates.
+class route_trie
+{
+public:
+    using route_type = std::size_t;
+    using route_list = std::pmr::vector<route_type>;
+
+    // Routes must be inserted in the registration order.
+    void insert(
+        std::optional<std::span<template_segment_ref const>> const& target,
+        route_type route)
+    {
+        if (!target)
+        {
+            fallback_routes_.push_back(route);
+            return;
+        }
+
+        if (nodes_.empty())
+        {
+            nodes_.emplace_back();
+        }
+
+        auto node = root;
+        for (auto const& segment : *target)
+        {
+            node = child(node, segment);
+        }
+
+        nodes_[node].routes.push_back(route);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return nodes_.empty() && fallback_routes_.empty();
+    }
+
+    // Merges the routes that might match the target segments into the sorted
+    // routes. The segments are null if the target is not a valid URI.
+    void lookup(
+        boost::urls::segments_encoded_view const* segments,
+        route_list& routes) const
+    {
+        if (segments && !nodes_.empty())
+        {
+            collect(root, segments->begin(), segments->end(), routes);
+        }
+
+        merge_routes(routes, fallback_routes_);
+    }
+
+private:
+    static constexpr std::size_t root = 0;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct node
+    {
+        std::unordered_map<
+            std::string,
+            std::size_t,
+            segment_hash,
+            std::equal_to<>> literals;
+        std::size_t param = npos;
+        std::size_t greedy_param = npos;
+        std::vector<route_type> routes;
+    };
+
+    std::size_t child(std::size_t parent, template_segment_ref const& segment)
+    {
+        switch (segment.type)
+        {
+        case template_segment_type::literal:
+        {
+            auto const iter = nodes_[parent].literals.find(segment.value);
+            if (iter != nodes_[parent].literals.end())
+            {
+                return iter->second;
+            }
+
+            auto const index = nodes_.size();
+            nodes_.emplace_back();
+            nodes_[parent].literals.emplace(std::string {segment.value}, index);
+            return index;
+        }
+
+        // Typed params share the child of the plain params. Converting the
+        // segment is left to the matcher which converts it only once and keeps
+        // the value for the handler args.
+        case template_segment_type::param:
+            if (nodes_[parent].param == npos)
+            {
+                nodes_[parent].param = nodes_.size();
+                nodes_.emplace_back();
+            }
+            return nodes_[parent].param;
+
+        case template_segment_type::greedy_param:
+            if (nodes_[parent].greedy_param == npos)
+            {
+                nodes_[parent].greedy_param = nodes_.size();
+                nodes_.emplace_back();
+            }
+            return nodes_[parent].greedy_param;
+        }
+
+        return parent;
+    }
+
+    template <typename IteratorType>
+    void collect(
+        std::size_t index,
+        IteratorType first,
+        IteratorType last,
+        route_list& routes) const
+    {
+        auto const& current = nodes_[index];
+
+        // A greedy param consumes zero or more segments.
+        if (current.greedy_param != npos)
+        {
+            for (auto iter = first; ; ++iter)
+            {
+                collect(current.greedy_param, iter, last, routes);
+                if (iter == last)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (first == last)
+        {
+            merge_routes(routes, current.routes);
+            return;
+        }
+
+        auto const next = std::next(first);
+
+        if (!current.literals.empty())
+        {
+            boost::urls::pct_string_view const segment = *first;
+            auto iter = current.literals.end();
+            if (segment.decoded_size() == segment.size())
+            {
+                // Nothing to decode, look it up in place.
+                iter = current.literals.find(
+                    std::string_view {segment.data(), segment.size()});
+            }
+            else
+            {
+                auto const decoded = *segment;
+                iter = current.literals.find(
+                    std::string {decoded.begin(), decoded.end()});
+            }
+
+            if (iter != current.literals.end())
+            {
+                collect(iter->second, next, last, routes);
+            }
+        }
+
+        if (current.param != npos)
+        {
+            collect(current.param, next, last, routes);
+        }
+    }
+
+    std::vector<node> nodes_;
+    std::vector<route_type> fallback_routes_;
+};
+
+} // namespace detail
+
+// Index of the registered routes. The routes are bucketed by the request method
+// in their hint, and each bucket is a segment trie of the target templates. A
+// lookup only visits the routes for any method and the routes of the request
+// method.
+class router
+{
+public:
+    using route_type = detail::route_trie::route_type;
+
+    // Candidate routes of a lookup. The session allocates them from the
+    // memory of the connection.
+    using route_list = detail::route_trie::route_list;
+
+    // Routes must be inserted in the registration order.
+    void insert(route_hint const& hint, route_type route)
+    {
+        if (!hint.method)
+        {
+            any_method_.insert(hint.target, route);
+            return;
+        }
+
+        auto const index = static_cast<std::size_t>(*hint.method);
+        if (methods_.size() <= index)
+        {
+            methods_.resize(index + 1);
+        }
+
+        methods_[index].insert(hint.target, route);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return
+            any_method_.empty() &&
+            std::ranges::all_of(methods_, &detail::route_trie::empty);
+    }
+
+    // Collects the routes that might match the request method and the parsed
+    // target, in the registration order. The target is null if the request
+    // target is not a valid URI, e.g. the target of the request cache of the
+    // matchers, so it's only parsed once. The matchers of the candidate routes
+    // still need to be evaluated to find the actual match.
+    void lookup(
+        boost::beast::http::verb method,
+        boost::urls::url_view const* target,
+        route_list& routes) const
+    {
+        routes.clear();
+
+        std::optional<boost::urls::segments_encoded_view> segments;
+        if (target)
+        {
+            segments = target->encoded_segments();
+        }
+
+        auto const* segments_ptr = segments ? &*segments : nullptr;
+        any_method_.lookup(segments_ptr, routes);
+
+        auto const index = static_cast<std::size_t>(method);
+        if (index < methods_.size())
+        {
+            methods_[index].lookup(segments_ptr, routes);
+        }
+    }
+
+private:
+    detail::route_trie any_method_;
+    std::vector<detail::route_trie> methods_;
+};
+
+} // namespace boost::taar::matcher
+
+#endif // BOOST_TAAR_MATCHER_ROUTER_HPP
@@ -12,131 +12,232 @@
 
 #include <boost/taar/matcher/context.hpp>
 #include <boost/taar/matcher/operand.hpp>
+#include <boost/taar/matcher/route_hint.hpp>
+#include <boost/taar/matcher/param_type.hpp>
 #include <boost/taar/matcher/template_parser.hpp>
-#include <boost/taar/matcher/detail/ranges_to.hpp>
-#include <boost/taar/matcher/detail/join_with.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/url/url_view.hpp>
-#include <ranges>
-#include <vector>
+#include <boost/url/pct_string_view.hpp>
+#include <iterator>
+#include <memory>
+#include <string_view>
 #include <string>
+#include <cstddef>
 
 namespace boost::taar::matcher {
+namespace detail {
 
-template<class FieldsType = boost::beast::http::fields>
-struct target_t
+inline bool segment_equals(
+    boost::urls::pct_string_view segment,
+    std::string_view literal)
 {
-    using request_type = boost::beast::http::request_header<FieldsType>;
+    // Literals are of known length so most mismatches are found without
+    // looking at the segment characters.
+    if (segment.decoded_size() != literal.size())
+    {
+        return false;
+    }
 
-    friend auto operator==(target_t, std::string_view target_template)
+    if (segment.size() == literal.size())
     {
-        auto const ptt = parse_template(target_template);
-        parsed_template template_segments {ptt.value().begin(), ptt.value().end()};
+        return std::string_view {segment.data(), segment.size()} == literal;
+    }
 
-        return matcher::operand
+    return *segment == literal;
+}
+
+// Matches the parsed target against the template segments and collects the
+// path args into the context.
+template <typename SegmentsType>
+bool match_target(
+    SegmentsType const& template_segments,
+    context& context,
+    boost::urls::url_view const& parsed_target)
+{
+    auto const& target_segments = parsed_target.encoded_segments();
+
+    auto target_iter = target_segments.begin();
+    auto template_iter = template_segments.begin();
+
+    auto greedy_target_iter = target_segments.end();
+    std::string_view greedy_param_name;
+
+    auto finish_greedy_param_if_any = [&]()
+    {
+        if (greedy_param_name.empty())
         {
-            [template_segments = std::move(template_segments)](
-                request_type const&,
-                context& context,
-                boost::urls::url_view const& parsed_target)
+            return;
+        }
+
+        // Segments of the target are contiguous in the target buffer, so the
+        // greedy param refers to the encoded slice of them and is only decoded
+        // if the value is asked for.
+        std::string_view value;
+        if (greedy_target_iter != target_iter)
+        {
+            boost::urls::pct_string_view const first = *greedy_target_iter;
+            boost::urls::pct_string_view const last = *std::prev(target_iter);
+            value = std::string_view {
+                first.data(),
+                static_cast<std::size_t>(last.data() + last.size() - first.data())};
+        }
+
+        context.path_args.emplace_encoded(greedy_param_name, value);
+        greedy_param_name = {};
+    };
+
+    while (template_iter != template_segments.end())
+    {
+        auto const& template_type = template_iter->type;
+        std::string_view const template_value = template_iter->value;
+
+        if (template_type == template_segment_type::greedy_param)
+        {
+            finish_greedy_param_if_any();
+
+            greedy_target_iter = target_iter;
+            greedy_param_name = template_value;
+
+            ++template_iter;
+            if (template_iter == template_segments.end())
+            {
+                // greedy param at the end, consume all remaining target segments
+                target_iter = target_segments.end();
+                break;
+            }
+            else if (target_iter != target_segments.end())
             {
-                auto const& target_segments = parsed_target.segments();
+                ++target_iter;
+            }
 
-                auto target_iter = target_segments.begin();
-                auto template_iter = template_segments.begin();
+            continue;
+        }
 
-                auto greedy_target_iter = target_segments.end();
-                std::string greedy_param_name;
+        if (target_iter == target_segments.end())
+        {
+            break;
+        }
+        boost::urls::pct_string_view const target_value = *target_iter;
 
-                auto finish_greedy_param_if_any = [&]()
+        if (template_type == template_segment_type::param)
+        {
+            // Typed params only match the segments valid for their type.
+            auto typed = parse_param(template_iter->param_type, target_value);
+            if (!typed)
+            {
+                if (!greedy_param_name.empty())
                 {
-                    if (greedy_param_name.empty())
-                    {
-                        return;
-                    }
+                    ++target_iter;
+                    continue;
+                }
 
-                    using namespace std::ranges;
-                    using namespace std::views;
+                return false;
+            }
 
-                    context.path_args.emplace(
-                        greedy_param_name,
-                        subrange(greedy_target_iter, target_iter) |
-                            detail::join_with('/') |
-                            detail::to<std::string>());
+            finish_greedy_param_if_any();
 
-                    greedy_param_name.clear();
-                };
+            context.path_args.emplace_encoded(
+                template_value,
+                std::string_view {target_value.data(), target_value.size()},
+                std::move(*typed));
 
-                while (template_iter != template_segments.end())
-                {
-                    auto const& template_type = template_iter->type;
-                    auto const& template_value = template_iter->value;
-
-                    if (template_type == template_segment_type::greedy_param)
-                    {
-                        finish_greedy_param_if_any();
-
-                        greedy_target_iter = target_iter;
-                        greedy_param_name = template_value;
-
-                        ++template_iter;
-                        if (template_iter == template_segments.end())
-                        {
-                            // greedy param at the end, consume all remaining target segments
-                            target_iter = target_segments.end();
-                            break;
-                        }
-                        else if (target_iter != target_segments.end())
-                        {
-                            ++target_iter;
-                        }
-
-                        continue;
-                    }
-
-                    if (target_iter == target_segments.end())
-                    {
-                        break;
-                    }
-                    auto const& target_value = *target_iter;
-
-                    if (template_type == template_segment_type::param)
-                    {
-                        finish_greedy_param_if_any();
-                        context.path_args.emplace(template_value, target_value);
-
-                        ++target_iter;
-                        ++template_iter;
-
-                        continue;
-                    }
-
-                    // template_type == template_segment_type::literal
-                    if (template_value == target_value)
-                    {
-                        finish_greedy_param_if_any();
-
-                        ++target_iter;
-                        ++template_iter;
-
-                        continue;
-                    }
-
-                    if (!greedy_param_name.empty())
-                    {
-                        ++target_iter;
-                        continue;
-                    }
-
-                    return false;
-                }
+            ++target_iter;
+            ++template_iter;
 
-                finish_greedy_param_if_any();
+            continue;
+        }
 
-                return
-                    target_iter == target_segments.end() &&
-                    template_iter == template_segments.end();
-            }
+        // template_type == template_segment_type::literal
+        if (segment_equals(target_value, template_value))
+        {
+            finish_greedy_param_if_any();
+
+            ++target_iter;
+            ++template_iter;
+
+            continue;
+        }
+
+        if (!greedy_param_name.empty())
+        {
+            ++target_iter;
+            continue;
+        }
+
+        return false;
+    }
+
+    finish_greedy_param_if_any();
+
+    return
+        target_iter == target_segments.end() &&
+        template_iter == template_segments.end();
+}
+
+// Template parsed at runtime along with the path its segments refer to.
+struct owned_template
+{
+    explicit owned_template(std::string_view target_template)
+        : path {target_template}
+        , segments {parse_template(path).value()}
+    {}
+
+    owned_template(owned_template const&) = delete;
+    owned_template& operator=(owned_template const&) = delete;
+
+    std::string const path;
+    parsed_template_ref const segments;
+};
+
+} // namespace detail
+
+template<class FieldsType = boost::beast::http::fields>
+struct target_t
+{
+    using request_type = boost::beast::http::request_header<FieldsType>;
+
+    friend auto operator==(target_t, std::string_view target_template)
+    {
+        // The segments refer to a copy of the template which is shared by the
+        // matcher and its hint.
+        auto const owned_template = std::make_shared<detail::owned_template const>(
+            target_template);
+        route_hint hint {owned_template->segments, owned_template};
+
+        return matcher::operand
+        {
+            [owned_template](
+                request_type const&,
+                context& context,
+                boost::urls::url_view const& parsed_target)
+            {
+                return detail::match_target(
+                    owned_template->segments,
+                    context,
+                    parsed_target);
+            },
+            std::move(hint)
+        };
+    }
+
+    // The route template is parsed at compile time and its segments are in
+    // static storage, so neither the matcher nor its hint allocates.
+    template <std::size_t N>
+    friend auto operator==(target_t, route_template<N> const& target_template)
+    {
+        return matcher::operand
+        {
+            [target_template](
+                request_type const&,
+                context& context,
+                boost::urls::url_view const& parsed_target)
+            {
+                return detail::match_target(
+                    target_template,
+                    context,
+                    parsed_target);
+            },
+            route_hint {target_template.segments}
         };
     }
 
@@ -145,15 +246,33 @@ struct target_t
         return operator==(target_t{}, target_template);
     }
 
+    template <std::size_t N>
+    friend auto operator==(route_template<N> const& target_template, target_t)
+    {
+        return operator==(target_t{}, target_template);
+    }
+
     friend auto operator!=(target_t, std::string_view target_template)
     {
         return !operator==(target_t{}, target_template);
     }
 
+    template <std::size_t N>
+    friend auto operator!=(target_t, route_template<N> const& target_template)
+    {
+        return !operator==(target_t{}, target_template);
+    }
+
     friend auto operator!=(std::string_view target_template, target_t)
     {
         return operator!=(target_t{}, target_template);
     }
+
+    template <std::size_t N>
+    friend auto operator!=(route_template<N> const& target_template, target_t)
+    {
+        return operator!=(target_t{}, target_template);
+    }
 };
 
 template<class FieldsType = boost::beast::http::fields>
@@ -10,10 +10,15 @@
 #ifndef BOOST_TAAR_MATCHER_TEMPLATE_PARSER_HPP
 #define BOOST_TAAR_MATCHER_TEMPLATE_PARSER_HPP
 
+#include <boost/taar/matcher/param_type.hpp>
 #include <boost/taar/core/error.hpp>
+#include <boost/taar/core/constexpr_string.hpp>
 #include <boost/system/result.hpp>
+#include <array>
+#include <span>
 #include <vector>
 #include <string_view>
+#include <cstddef>
 
 namespace boost::taar::matcher {
 namespace detail {
@@ -68,10 +73,14 @@ struct template_segment
 {
     template_segment_type type;
     std::string value;
+    template_param_type param_type = template_param_type::string;
 
     constexpr bool operator==(template_segment const& other) const
     {
-        return type == other.type && value == other.value;
+        return
+            type == other.type &&
+            value == other.value &&
+            param_type == other.param_type;
     }
 };
 
@@ -81,22 +90,31 @@ struct template_segment_ref
 {
     template_segment_type type;
     std::string_view value;
+    template_param_type param_type = template_param_type::string;
 
     constexpr bool operator==(template_segment_ref const& other) const
     {
-        return type == other.type && value == other.value;
+        return
+            type == other.type &&
+            value == other.value &&
+            param_type == other.param_type;
     }
 
     constexpr operator template_segment() const
     {
-        return template_segment{type, std::string(value)};
+        return template_segment{type, std::string(value), param_type};
     }
 };
 
 using parsed_template_ref = std::vector<template_segment_ref>;
 
-inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
-    std::string_view path)
+namespace detail {
+
+// Parses the template path and calls the emit callback for each segment. It is
+// usable in constant expressions so the templates known at compile time can be
+// parsed and validated by the compiler.
+template <typename EmitType>
+constexpr error parse_template_segments(std::string_view path, EmitType&& emit)
 {
     enum class states : char
     {
@@ -105,21 +123,23 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
         start_param,
         start_greedy_param,
         in_param,
+        in_param_type,
         end_param,
         in_literal,
     } state = states::start;
 
-    parsed_template_ref result;
-    std::string_view::iterator value_begin;
-    std::string_view::iterator value_end;
+    std::size_t value_begin = 0;
+    std::size_t value_end = 0;
+    std::size_t type_begin = 0;
     bool is_greedy_param = false;
 
-    for (auto iter = path.begin(); iter != path.end(); ++iter)
+    for (std::size_t index = 0; index != path.size(); ++index)
     {
+        char const ch = path[index];
         switch (state)
         {
         case states::start:
-            if (*iter != '/')
+            if (ch != '/')
             {
                 return error::no_absolute_template;
             }
@@ -127,21 +147,21 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             break;
 
         case states::start_segment:
-            if (*iter == '/')
+            if (ch == '/')
             {
                 // Extra slashes in paths are ignored.
                 break;
             }
 
-            if (*iter == '{')
+            if (ch == '{')
             {
                 state = states::start_param;
                 break;
             }
 
-            if (detail::validate_literal_char(*iter))
+            if (validate_literal_char(ch))
             {
-                value_begin = iter;
+                value_begin = index;
 
                 state = states::in_literal;
                 break;
@@ -150,16 +170,16 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             return error::invalid_template;
 
         case states::start_param:
-            if (*iter == '*')
+            if (ch == '*')
             {
                 state = states::start_greedy_param;
                 break;
             }
 
-            if (detail::validate_param_start(*iter))
+            if (validate_param_start(ch))
             {
                 is_greedy_param = false;
-                value_begin = iter;
+                value_begin = index;
 
                 state = states::in_param;
                 break;
@@ -168,10 +188,10 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             return error::invalid_template;
 
         case states::start_greedy_param:
-            if (detail::validate_param_start(*iter))
+            if (validate_param_start(ch))
             {
                 is_greedy_param = true;
-                value_begin = iter;
+                value_begin = index;
 
                 state = states::in_param;
                 break;
@@ -180,22 +200,55 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             return error::invalid_template;
 
         case states::in_param:
-            if (*iter == '}')
+            if (ch == '}')
             {
-                value_end = iter;
-
-                result.emplace_back(
+                emit(
                     is_greedy_param ?
                         template_segment_type::greedy_param :
                         template_segment_type::param,
-                    std::string_view(value_begin, value_end));
+                    path.substr(value_begin, index - value_begin),
+                    template_param_type::string);
+
+                state = states::end_param;
+                break;
+            }
+
+            if (ch == ':' && !is_greedy_param)
+            {
+                value_end = index;
+                type_begin = index + 1;
+
+                state = states::in_param_type;
+                break;
+            }
+
+            if (validate_param_char(ch))
+            {
+                break;
+            }
 
+            return error::invalid_template;
+
+        case states::in_param_type:
+            if (ch == '}')
+            {
+                auto const param_type = param_type_from_name(
+                    path.substr(type_begin, index - type_begin));
+                if (!param_type)
+                {
+                    return error::invalid_template;
+                }
+
+                emit(
+                    template_segment_type::param,
+                    path.substr(value_begin, value_end - value_begin),
+                    *param_type);
 
                 state = states::end_param;
                 break;
             }
 
-            if (detail::validate_param_char(*iter))
+            if (is_alphanum(ch))
             {
                 break;
             }
@@ -203,7 +256,7 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             return error::invalid_template;
 
         case states::end_param:
-            if (*iter == '/')
+            if (ch == '/')
             {
                 state = states::start_segment;
                 break;
@@ -211,16 +264,17 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
             return error::invalid_template;
 
         case states::in_literal:
-            if (*iter == '/')
+            if (ch == '/')
             {
-                result.emplace_back(
+                emit(
                     template_segment_type::literal,
-                    std::string_view(value_begin, iter));
+                    path.substr(value_begin, index - value_begin),
+                    template_param_type::string);
 
                 state = states::start_segment;
                 break;
             }
-            else if (detail::validate_literal_char(*iter))
+            else if (validate_literal_char(ch))
             {
                 break;
             }
@@ -234,18 +288,146 @@ inline /*constexpr*/ boost::system::result<parsed_template_ref> parse_template(
     }
     else if (state == states::in_literal)
     {
-        result.emplace_back(
+        emit(
             template_segment_type::literal,
-            std::string_view(value_begin, path.end()));
+            path.substr(value_begin),
+            template_param_type::string);
     }
     else if (state != states::start_segment && state != states::end_param)
     {
         return error::invalid_template;
     }
 
+    return error::success;
+}
+
+// Number of segments of a template path or the parse error.
+struct template_segments_count
+{
+    error ec;
+    std::size_t count;
+};
+
+constexpr template_segments_count count_template_segments(std::string_view path)
+{
+    std::size_t count = 0;
+    auto const ec = parse_template_segments(
+        path,
+        [&](template_segment_type, std::string_view, template_param_type)
+        {
+            ++count;
+        });
+
+    return {ec, count};
+}
+
+} // namespace detail
+
+inline boost::system::result<parsed_template_ref> parse_template(
+    std::string_view path)
+{
+    parsed_template_ref result;
+    auto const ec = detail::parse_template_segments(
+        path,
+        [&](
+            template_segment_type type,
+            std::string_view value,
+            template_param_type param_type)
+        {
+            result.emplace_back(type, value, param_type);
+        });
+
+    if (ec != error::success)
+    {
+        return ec;
+    }
+
     return result;
 }
 
+// A template path parsed at compile time. The segments are kept in static
+// storage and refer to the characters of the literal it is created from, so
+// the route template is cheap to copy and its segments are never invalidated.
+template <std::size_t N>
+struct route_template
+{
+    using value_type = template_segment_ref;
+    using const_iterator = typename std::span<template_segment_ref const, N>::iterator;
+
+    std::span<template_segment_ref const, N> segments;
+
+    constexpr const_iterator begin() const noexcept
+    {
+        return segments.begin();
+    }
+
+    constexpr const_iterator end() const noexcept
+    {
+        return segments.end();
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return N;
+    }
+
+    constexpr template_segment_ref const& operator[](std::size_t index) const
+    {
+        return segments[index];
+    }
+};
+
+namespace detail {
+
+template <constexpr_string Template>
+inline constexpr std::string_view template_path {Template.c_str(), Template.size()};
+
+template <constexpr_string Template>
+inline constexpr auto route_template_segments = []
+{
+    std::array<
+        template_segment_ref,
+        count_template_segments(template_path<Template>).count> result {};
+    std::size_t index = 0;
+    parse_template_segments(
+        template_path<Template>,
+        [&](
+            template_segment_type type,
+            std::string_view value,
+            template_param_type param_type)
+        {
+            result[index++] = template_segment_ref {type, value, param_type};
+        });
+
+    return result;
+}();
+
+} // namespace detail
+
 } // namespace boost::taar::matcher
 
+namespace boost::taar::literals {
+
+// Route template literal which is parsed and validated at compile time, e.g.
+// target == "/api/{id}"_route
+template <constexpr_string Template>
+consteval auto operator""_route()
+{
+    using namespace boost::taar::matcher;
+
+    constexpr auto parsed = detail::count_template_segments(
+        detail::template_path<Template>);
+    static_assert(
+        parsed.ec != error::no_absolute_template,
+        "Specified route template is not an absolute path.");
+    static_assert(
+        parsed.ec != error::invalid_template,
+        "Invalid route template path.");
+
+    return route_template<parsed.count> {
+        detail::route_template_segments<Template>};
+}
+
+} // namespace boost::taar::literals
+
 #endif // BOOST_TAAR_MATCHER_TEMPLATE_PARSER_HPP
@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SERVER_MULTI_CORE_HPP
+#define BOOST_TAAR_SERVER_MULTI_CORE_HPP
+
+#include <boost/taar/server/tcp.hpp>
+#include <boost/taar/server/tcp_options.hpp>
+#include <boost/taar/core/cancellation_signals.hpp>
+#include <boost/taar/core/ignore_and_rethrow.hpp>
+#include <boost/taar/type_traits/callable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace boost::taar::server {
+
+// Runs a tcp server on several cores without sharing anything between them on
+// the hot path. Each core gets its own io_context which is run by a single
+// thread pinned to the core, and its own acceptor of the listening port bound
+// with SO_REUSEPORT, so the kernel balances the connections between the cores
+// instead of them contending for a shared accept queue. The sessions of a
+// connection stay on the core which accepted it.
+class multi_core
+{
+public:
+    explicit multi_core(std::size_t concurrency = available_cores().size())
+    {
+        concurrency = std::max<std::size_t>(concurrency, 1);
+        contexts_.reserve(concurrency);
+        for (std::size_t index = 0; index != concurrency; ++index)
+        {
+            // Each io_context is only run by one thread.
+            contexts_.push_back(std::make_unique<boost::asio::io_context>(1));
+        }
+    }
+
+    multi_core(multi_core const&) = delete;
+    multi_core& operator=(multi_core const&) = delete;
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return contexts_.size();
+    }
+
+    [[nodiscard]] boost::asio::io_context& context(std::size_t index) noexcept
+    {
+        return *contexts_[index];
+    }
+
+    // Spawns a tcp server on each io_context. Every core gets its own session
+    // handler, default constructed and then set up by invoking setup with it,
+    // e.g. to register the routes of a session::http, so the handlers and the
+    // state of their callables are never shared between the threads. The
+    // session handler type is deduced from the parameter of setup, which must
+    // therefore not be a generic lambda. The local endpoint handler is invoked
+    // once the first acceptor is listening, and the rest of the acceptors bind
+    // the same port, even if an ephemeral port is requested. The options apply
+    // to each of the servers, so the connection limit is per core.
+    template <typename Setup>
+    void listen(
+        std::string bind_host,
+        std::string bind_port,
+        Setup setup,
+        cancellation_signals& signals,
+        std::function<void(boost::asio::ip::tcp::endpoint const&)> local_endpoint_handler = nullptr,
+        tcp_options options = {})
+    {
+        namespace net = boost::asio;
+        using session_handler_type = std::remove_cvref_t<
+            type_traits::callable_arg<Setup, 0>>;
+
+        // The handlers are owned here as they must outlive the servers.
+        std::vector<session_handler_type*> session_handlers;
+        session_handlers.reserve(size());
+        for (std::size_t index = 0; index != size(); ++index)
+        {
+            auto session_handler = std::make_shared<session_handler_type>();
+            setup(*session_handler);
+            session_handlers.push_back(session_handler.get());
+            session_handlers_.push_back(std::move(session_handler));
+        }
+
+        options.reuse_port = true;
+        net::co_spawn(
+            context(0),
+            tcp(
+                std::move(bind_host),
+                std::move(bind_port),
+                *session_handlers[0],
+                signals,
+                [this, session_handlers, &signals, options,
+                    local_endpoint_handler = std::move(local_endpoint_handler)](
+                    net::ip::tcp::endpoint const& endpoint)
+                {
+                    for (std::size_t index = 1; index != size(); ++index)
+                    {
+                        net::co_spawn(
+                            context(index),
+                            tcp(
+                                endpoint.address().to_string(),
+                                std::to_string(endpoint.port()),
+                                *session_handlers[index],
+                                signals,
+                                nullptr,
+                                options),
+                            signals.bind(ignore_and_rethrow));
+                    }
+
+                    if (local_endpoint_handler)
+                    {
+                        local_endpoint_handler(endpoint);
+                    }
+                },
+                options),
+            signals.bind(ignore_and_rethrow));
+    }
+
+    // Runs each io_context on its own thread pinned to a core and blocks until
+    // all of them are stopped or out of work.
+    void run()
+    {
+        auto const cores = available_cores();
+        std::vector<std::jthread> threads;
+        threads.reserve(size());
+        for (std::size_t index = 0; index != size(); ++index)
+        {
+            threads.emplace_back([this, index, &cores]
+            {
+                pin_to_core(cores[index % cores.size()]);
+                context(index).run();
+            });
+        }
+    }
+
+    void stop()
+    {
+        for (auto& context : contexts_)
+        {
+            context->stop();
+        }
+    }
+
+private:
+    // The cores this process may run on, which may be a subset of the cores of
+    // the machine, e.g. in a container or under taskset.
+    static std::vector<int> available_cores()
+    {
+        std::vector<int> cores;
+#if defined(__linux__)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+        {
+            for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &cpu_set))
+                {
+                    cores.push_back(cpu);
+                }
+            }
+            return cores;
+        }
+#endif
+        cores.resize(std::max(std::thread::hardware_concurrency(), 1u));
+        for (std::size_t cpu = 0; cpu != cores.size(); ++cpu)
+        {
+            cores[cpu] = static_cast<int>(cpu);
+        }
+        return cores;
+    }
+
+    static void pin_to_core(int core) noexcept
+    {
+#if defined(__linux__)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core, &cpu_set);
+
+        // Not being pinned is only a performance concern.
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#else
+        (void) core;
+#endif
+    }
+
+    // Declared first so the handlers outlive the sessions on the io_contexts.
+    std::vector<std::shared_ptr<void>> session_handlers_;
+
+    // The io_contexts are not movable and their addresses must be stable.
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts_;
+};
+
+} // namespace boost::taar::server
+
+#endif // BOOST_TAAR_SERVER_MULTI_CORE_HPP
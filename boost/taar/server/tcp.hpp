@@ -13,40 +13,472 @@
 #include <boost/taar/core/awaitable.hpp>
 #include <boost/taar/core/cancellation_signals.hpp>
 #include <boost/taar/core/rebind_executor.hpp>
+#include <boost/taar/server/tcp_options.hpp>
+#include <boost/taar/server/tcp_metrics.hpp>
+#include <boost/taar/type_traits/specialization_of.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/this_coro.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
-#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/consign.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/append.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/experimental/parallel_group.hpp>
 #include <system_error>
+#include <functional>
+#include <exception>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 namespace boost::taar::server {
+namespace detail {
 
-// tcp server coroutine to be spawned for each tcp server instance.
-template <typename SessionHandler> // TODO: SessionHandler concept for callable with correct syntax
-[[nodiscard]] awaitable<void> tcp(
+// Executor of a newly accepted connection. Each connection gets its own strand
+// if the server runs on a strand, so the connections run concurrently on the
+// threads of the underlying executor.
+template <typename ExecutorType, typename SocketType, typename AcceptorType>
+typename SocketType::executor_type connection_executor(AcceptorType& acceptor)
+{
+    using executor_type = typename SocketType::executor_type;
+
+    if constexpr (type_traits::specialization_of<boost::asio::strand, ExecutorType>)
+    {
+        return executor_type {boost::asio::make_strand(
+            acceptor.get_executor().get_inner_executor())};
+    }
+    else
+    {
+        return acceptor.get_executor();
+    }
+}
+
+// Admission of the connections of a server up to the connection limit. The
+// accept loops wait on the gate while it's full and a finishing session opens
+// it again.
+template <typename ExecutorType>
+class connection_gate
+    : public std::enable_shared_from_this<connection_gate<ExecutorType>>
+{
+public:
+    connection_gate(ExecutorType const& executor, tcp_options const& options)
+        : max_connections_ {options.max_connections}
+        , max_draining_ {options.max_draining}
+        , metrics_ {options.metrics}
+        , timer_ {executor, std::chrono::steady_clock::time_point::max()}
+    {}
+
+    // Takes the place of a connection if the gate isn't full.
+    bool try_enter() noexcept
+    {
+        auto live = live_.load(std::memory_order_relaxed);
+        do
+        {
+            if (max_connections_ != 0 && live >= max_connections_)
+            {
+                return false;
+            }
+        }
+        while (!live_.compare_exchange_weak(live, live + 1, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    // Number of times the gate opened after being full. Read before trying
+    // to enter, to wait for the next opening.
+    [[nodiscard]] std::uint64_t openings() const noexcept
+    {
+        return openings_.load(std::memory_order_acquire);
+    }
+
+    // Gives back the place of a connection.
+    void leave()
+    {
+        if (live_.fetch_sub(1, std::memory_order_relaxed) == max_connections_)
+        {
+            // The loops only wait while the gate is full. The timer never
+            // expires and cancelling it wakes up the waiting loops.
+            openings_.fetch_add(1, std::memory_order_release);
+            boost::asio::post(
+                timer_.get_executor(),
+                [self = this->shared_from_this()]
+                {
+                    std::lock_guard<std::mutex> const lock {self->mutex_};
+                    self->timer_.cancel();
+                });
+        }
+    }
+
+    // Waits until the gate opens after the given opening, or the loop is
+    // cancelled. A gate which opened in the meantime completes right away,
+    // so a connection leaving between a failed try_enter and the wait isn't
+    // missed.
+    awaitable<void, ExecutorType> wait(std::uint64_t seen)
+    {
+        using token_type = boost::asio::as_tuple_t<
+            boost::asio::use_awaitable_t<ExecutorType>>;
+
+        if (metrics_)
+        {
+            ++metrics_->paused_accepts;
+        }
+
+        co_await boost::asio::async_initiate<
+            void(boost::system::error_code)>(
+            [this, seen](auto handler)
+            {
+                // The wait is armed under the lock, so the cancellation of an
+                // opening which isn't seen here can't run before it.
+                std::lock_guard<std::mutex> const lock {mutex_};
+                if (openings_.load(std::memory_order_acquire) != seen)
+                {
+                    return boost::asio::post(
+                        timer_.get_executor(),
+                        boost::asio::append(
+                            std::move(handler),
+                            boost::system::error_code {}));
+                }
+
+                timer_.async_wait(std::move(handler));
+            },
+            token_type {});
+    }
+
+    // Takes the place of a rejected connection to drain if there are less
+    // than the max number of them.
+    bool try_drain() noexcept
+    {
+        auto draining = draining_.load(std::memory_order_relaxed);
+        do
+        {
+            if (draining >= max_draining_)
+            {
+                return false;
+            }
+        }
+        while (!draining_.compare_exchange_weak(draining, draining + 1, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    // Gives back the place of a drained connection.
+    void drained() noexcept
+    {
+        draining_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] tcp_metrics* metrics() const noexcept
+    {
+        return metrics_;
+    }
+
+private:
+    std::size_t const max_connections_;
+    std::size_t const max_draining_;
+    tcp_metrics* const metrics_;
+    std::atomic<std::size_t> live_ = 0;
+    std::atomic<std::size_t> draining_ = 0;
+    std::atomic<std::uint64_t> openings_ = 0;
+
+    // The timer is shared by the accept loops and the leaving sessions, which
+    // may run on different threads.
+    std::mutex mutex_;
+    rebind_executor<boost::asio::steady_timer, ExecutorType> timer_;
+};
+
+// Writes the overload response to a connection over the limit, then reads and
+// discards what the client sends until it closes its side or the drain time is
+// over, so closing the socket doesn't reset the connection.
+template <typename ExecutorType, typename SocketType>
+awaitable<void, ExecutorType> reject_connection(
+    SocketType socket,
+    std::string_view response,
+    std::chrono::steady_clock::duration drain)
+{
+    namespace net = boost::asio;
+
+    auto [ec, size] = co_await net::async_write(
+        socket,
+        net::buffer(response));
+    if (ec)
+    {
+        co_return;
+    }
+
+    socket.shutdown(net::socket_base::shutdown_send, ec);
+    rebind_executor<net::steady_timer, ExecutorType> timer {
+        socket.get_executor(),
+        drain};
+    char discarded[512];
+    for (;;)
+    {
+        auto [order, read_ec, read_size, timer_ec] =
+            co_await net::experimental::make_parallel_group(
+                socket.async_read_some(net::buffer(discarded), net::deferred),
+                timer.async_wait(net::deferred)).async_wait(
+                    net::experimental::wait_for_one(),
+                    net::deferred);
+        if (order[0] != 0 || read_ec)
+        {
+            break;
+        }
+    }
+
+    socket.close(ec);
+}
+
+// Closes a rejected connection right after the overload response, which is
+// only written if the socket can take it without waiting.
+template <typename SocketType>
+void close_rejected_connection(SocketType& socket, std::string_view response)
+{
+    boost::system::error_code ec;
+    socket.non_blocking(true, ec);
+    socket.write_some(boost::asio::buffer(response), ec);
+    socket.close(ec);
+}
+
+// Place of a drained connection in the gate. It's kept by the completion
+// handler of the drain and leaves the gate when the handler is destroyed.
+template <typename ExecutorType>
+class drain_guard
+{
+public:
+    explicit drain_guard(std::shared_ptr<connection_gate<ExecutorType>> gate) noexcept
+        : gate_ {std::move(gate)}
+    {}
+
+    drain_guard(drain_guard&&) noexcept = default;
+    drain_guard& operator=(drain_guard&&) = delete;
+
+    ~drain_guard()
+    {
+        if (gate_)
+        {
+            gate_->drained();
+        }
+    }
+
+private:
+    std::shared_ptr<connection_gate<ExecutorType>> gate_;
+};
+
+// Place of a running session in the gate. It's kept by the completion handler
+// of the session and leaves the gate when the handler is destroyed.
+template <typename ExecutorType>
+class connection_guard
+{
+public:
+    explicit connection_guard(std::shared_ptr<connection_gate<ExecutorType>> gate) noexcept
+        : gate_ {std::move(gate)}
+    {
+        if (auto* metrics = gate_->metrics())
+        {
+            ++metrics->live_connections;
+        }
+    }
+
+    connection_guard(connection_guard&&) noexcept = default;
+    connection_guard& operator=(connection_guard&&) = delete;
+
+    ~connection_guard()
+    {
+        if (gate_)
+        {
+            if (auto* metrics = gate_->metrics())
+            {
+                --metrics->live_connections;
+            }
+            gate_->leave();
+        }
+    }
+
+private:
+    std::shared_ptr<connection_gate<ExecutorType>> gate_;
+};
+
+// Accepts connections and spawns their sessions until cancelled. Several loops
+// can share the acceptor.
+template <typename ExecutorType, typename AcceptorType, typename SessionHandler>
+awaitable<void, ExecutorType> accept_loop(
+    AcceptorType& acceptor,
+    SessionHandler& session_handler,
+    cancellation_signals& signals,
+    tcp_options const& options,
+    std::shared_ptr<connection_gate<ExecutorType>> const& gate)
+{
+    namespace net = boost::asio;
+    namespace this_coro = net::this_coro;
+    using socket_type = rebind_executor<net::ip::tcp::socket, ExecutorType>;
+
+    // Without an overload response, the place of a connection is taken
+    // before it's accepted, so the connections over the limit stay in the
+    // backlog.
+    bool const pause_at_limit = options.overload_response.empty();
+
+    // Starts the session of an accepted connection, or closes the connection
+    // with the overload response if there's no place for it.
+    auto start_session = [&](socket_type socket, bool entered)
+    {
+        auto const executor = socket.get_executor();
+        if (!entered && !gate->try_enter())
+        {
+            if (options.metrics)
+            {
+                ++options.metrics->rejected_connections;
+            }
+
+            if (!gate->try_drain())
+            {
+                close_rejected_connection(socket, options.overload_response);
+                return;
+            }
+
+            net::co_spawn(
+                executor,
+                reject_connection<ExecutorType>(
+                    std::move(socket),
+                    options.overload_response,
+                    options.overload_drain),
+                signals.bind(net::consign(
+                    net::detached,
+                    drain_guard<ExecutorType> {gate})));
+            return;
+        }
+
+        net::co_spawn(
+            executor,
+            session_handler(std::move(socket), signals),
+            signals.bind(net::consign(
+                net::detached,
+                connection_guard<ExecutorType> {gate})));
+    };
+
+    rebind_executor<net::steady_timer, ExecutorType> backoff {
+        co_await this_coro::executor};
+
+    for (auto cs = co_await this_coro::cancellation_state;
+         cs.cancelled() == net::cancellation_type::none;
+         cs = co_await this_coro::cancellation_state)
+    {
+        if (pause_at_limit)
+        {
+            auto const seen = gate->openings();
+            if (!gate->try_enter())
+            {
+                co_await gate->wait(seen);
+                continue;
+            }
+        }
+
+        auto [ec, socket] = co_await acceptor.async_accept(
+            connection_executor<ExecutorType, socket_type>(acceptor));
+        if (ec)
+        {
+            if (pause_at_limit)
+            {
+                gate->leave();
+            }
+
+            if (ec == net::error::operation_aborted)
+            {
+                continue;
+            }
+
+            if (options.metrics)
+            {
+                ++options.metrics->accept_errors;
+            }
+
+            // The error is likely to persist for a while, e.g. out of file
+            // descriptors, so the accept is retried after a delay.
+            backoff.expires_after(options.accept_error_backoff);
+            co_await backoff.async_wait();
+            continue;
+        }
+
+        start_session(std::move(socket), pause_at_limit);
+
+        // Take the connections which are already waiting. The acceptor is
+        // non-blocking, so this stops as soon as the backlog is empty.
+        std::uint64_t accepted = 1;
+        while (accepted < options.accept_batch)
+        {
+            if (pause_at_limit && !gate->try_enter())
+            {
+                break;
+            }
+
+            boost::system::error_code batch_ec;
+            auto next_socket = acceptor.accept(
+                connection_executor<ExecutorType, socket_type>(acceptor),
+                batch_ec);
+            if (batch_ec)
+            {
+                if (pause_at_limit)
+                {
+                    gate->leave();
+                }
+
+                if (options.metrics &&
+                    batch_ec != net::error::would_block &&
+                    batch_ec != net::error::try_again)
+                {
+                    ++options.metrics->accept_errors;
+                }
+                break;
+            }
+
+            start_session(std::move(next_socket), pause_at_limit);
+            ++accepted;
+        }
+
+        if (options.metrics)
+        {
+            options.metrics->accepted += accepted;
+            ++options.metrics->wakeups;
+        }
+    }
+}
+
+} // namespace detail
+
+// tcp server coroutine to be spawned for each tcp server instance. The server
+// and its sessions run on ExecutorType.
+template <typename ExecutorType = default_executor, typename SessionHandler> // TODO: SessionHandler concept for callable with correct syntax
+[[nodiscard]] awaitable<void, ExecutorType> tcp(
     std::string bind_host,
     std::string bind_port,
     SessionHandler&& session_handler,
     cancellation_signals& signals,
-    std::function<void(boost::asio::ip::tcp::endpoint const&)> local_endpoint_handler = nullptr)
+    std::function<void(boost::asio::ip::tcp::endpoint const&)> local_endpoint_handler = nullptr,
+    tcp_options options = {})
 {
     namespace net = boost::asio;
     namespace this_coro = net::this_coro;
     using net::ip::tcp;
     using net::co_spawn;
-    using net::detached;
 
-    rebind_executor<tcp::resolver> resolver {co_await this_coro::executor};
+    rebind_executor<tcp::resolver, ExecutorType> resolver {co_await this_coro::executor};
     auto [ec, query] = co_await resolver.async_resolve(bind_host, bind_port);
     if (ec)
     {
         throw std::system_error {ec};
     }
 
-    rebind_executor<tcp::acceptor> acceptor {co_await this_coro::executor};
+    rebind_executor<tcp::acceptor, ExecutorType> acceptor {co_await this_coro::executor};
 
     // Open the acceptor
     acceptor.open(query.begin()->endpoint().protocol());
@@ -54,6 +486,14 @@ template <typename SessionHandler> // TODO: SessionHandler concept for callable
     // Allow address reuse
     acceptor.set_option(net::socket_base::reuse_address(true));
 
+#if defined(SO_REUSEPORT)
+    // Share the port with the acceptors of the other io_contexts
+    if (options.reuse_port)
+    {
+        acceptor.set_option(reuse_port(true));
+    }
+#endif
+
     // Bind to the server address
     acceptor.bind(query.begin()->endpoint());
 
@@ -65,18 +505,53 @@ template <typename SessionHandler> // TODO: SessionHandler concept for callable
         local_endpoint_handler(acceptor.local_endpoint());
     }
 
-    for (auto cs = co_await this_coro::cancellation_state;
-         cs.cancelled() == net::cancellation_type::none;
-         cs = co_await this_coro::cancellation_state)
+    if (options.accept_batch > 1)
+    {
+        // The batches are accepted synchronously until the backlog is empty.
+        acceptor.non_blocking(true);
+    }
+
+    // Shared by the accept loops and the running sessions.
+    auto const gate = std::make_shared<detail::connection_gate<ExecutorType>>(
+        co_await this_coro::executor,
+        options);
+
+    if (options.accept_concurrency <= 1)
     {
-        auto [ec, socket] = co_await acceptor.async_accept();
-        if (!ec)
+        co_await detail::accept_loop<ExecutorType>(
+            acceptor, session_handler, signals, options, gate);
+        co_return;
+    }
+
+    // Several accept operations are kept outstanding on the acceptor. All the
+    // loops are cancelled together with the server.
+    auto const executor = co_await this_coro::executor;
+    using loop_type = decltype(co_spawn(
+        executor,
+        detail::accept_loop<ExecutorType>(
+            acceptor, session_handler, signals, options, gate),
+        net::deferred));
+    std::vector<loop_type> loops;
+    loops.reserve(options.accept_concurrency);
+    for (std::size_t i = 0; i != options.accept_concurrency; ++i)
+    {
+        loops.push_back(co_spawn(
+            executor,
+            detail::accept_loop<ExecutorType>(
+                acceptor, session_handler, signals, options, gate),
+            net::deferred));
+    }
+
+    auto [order, exceptions] = co_await net::experimental::make_parallel_group(
+        std::move(loops)).async_wait(
+            net::experimental::wait_for_all(),
+            net::deferred);
+
+    for (auto const& eptr : exceptions)
+    {
+        if (eptr)
         {
-            auto const executor = socket.get_executor();
-            co_spawn(
-                executor,
-                std::forward<SessionHandler>(session_handler)(std::move(socket), signals),
-                net::bind_cancellation_slot(signals.slot(), detached));
+            std::rethrow_exception(eptr);
         }
     }
 }
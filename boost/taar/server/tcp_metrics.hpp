@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SERVER_TCP_METRICS_HPP
+#define BOOST_TAAR_SERVER_TCP_METRICS_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace boost::taar::server {
+
+// Counters of the acceptors of a tcp server, which can be shared by the
+// servers of several io_contexts. The accept rate and the average batch size
+// follow from sampling the counters over time.
+struct tcp_metrics
+{
+    // Connections accepted.
+    std::atomic<std::uint64_t> accepted {0};
+
+    // Accept operations which completed with a connection, each followed by
+    // a batch of the connections which were already waiting.
+    std::atomic<std::uint64_t> wakeups {0};
+
+    // Accepts which failed, e.g. when out of file descriptors.
+    std::atomic<std::uint64_t> accept_errors {0};
+
+    // Connections whose sessions are running.
+    std::atomic<std::uint64_t> live_connections {0};
+
+    // Connections closed with the overload response at the limit.
+    std::atomic<std::uint64_t> rejected_connections {0};
+
+    // Times an accept loop paused at the limit until a session finished.
+    std::atomic<std::uint64_t> paused_accepts {0};
+};
+
+} // namespace boost::taar::server
+
+#endif // BOOST_TAAR_SERVER_TCP_METRICS_HPP
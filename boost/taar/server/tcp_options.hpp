@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SERVER_TCP_OPTIONS_HPP
+#define BOOST_TAAR_SERVER_TCP_OPTIONS_HPP
+
+#include <boost/taar/server/tcp_metrics.hpp>
+#include <boost/asio/detail/socket_option.hpp>
+#include <boost/asio/detail/socket_types.hpp>
+#include <string_view>
+#include <chrono>
+#include <cstddef>
+
+namespace boost::taar::server {
+
+#if defined(SO_REUSEPORT)
+// Socket option to let several sockets bind the same address and port. The
+// kernel balances the incoming connections between their accept queues.
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+// Canned response of an HTTP server which is over its connection limit.
+inline constexpr std::string_view http_service_unavailable =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+// Options of the listening socket of a tcp server.
+struct tcp_options
+{
+    // Binds the acceptor with SO_REUSEPORT so each thread or io_context can
+    // have its own acceptor of the same port. Ignored where the option isn't
+    // supported.
+    bool reuse_port = false;
+
+    // Number of accept operations kept outstanding on the acceptor, so a
+    // connection storm is drained by several accept loops at once.
+    std::size_t accept_concurrency = 1;
+
+    // Max number of connections accepted per wakeup of an accept loop. The
+    // connections which are already waiting in the backlog after an accept
+    // completes are taken right away without going through the event loop.
+    std::size_t accept_batch = 1;
+
+    // Max number of connections whose sessions run at once, or zero for no
+    // limit. At the limit, the server stops accepting and leaves the new
+    // connections in the backlog until a session finishes, unless there's an
+    // overload response.
+    std::size_t max_connections = 0;
+
+    // Bytes written to the connections accepted at the limit before they are
+    // closed, e.g. http_service_unavailable. Must outlive the server.
+    std::string_view overload_response;
+
+    // Max time to read and discard what the client of a rejected connection
+    // sends after the overload response, until it closes its side. Closing a
+    // socket with unread bytes resets the connection, which can destroy the
+    // overload response before the client reads it.
+    std::chrono::steady_clock::duration overload_drain = std::chrono::seconds {1};
+
+    // Max number of rejected connections drained at once. The ones over it
+    // are closed right after the overload response, so a flood of rejected
+    // connections can't hold on to file descriptors.
+    std::size_t max_draining = 64;
+
+    // Delay before accepting again after an accept fails, e.g. when out of
+    // file descriptors, so the loop doesn't spin on the failing accept.
+    std::chrono::steady_clock::duration accept_error_backoff = std::chrono::milliseconds {100};
+
+    // Counters of the accepted connections, if not null. Must outlive the
+    // server and its connections.
+    tcp_metrics* metrics = nullptr;
+};
+
+} // namespace boost::taar::server
+
+#endif // BOOST_TAAR_SERVER_TCP_OPTIONS_HPP
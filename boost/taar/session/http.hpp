@@ -16,17 +16,23 @@
 #include <boost/beast/http/fields.hpp>
 #include <boost/taar/matcher/context.hpp>
 #include <boost/taar/matcher/operand.hpp>
+#include <boost/taar/matcher/router.hpp>
+#include <boost/taar/session/http_timeouts.hpp>
+#include <boost/taar/session/http_metrics.hpp>
+#include <boost/taar/session/route_options.hpp>
 #include <boost/taar/core/response_from.hpp>
 #include <boost/taar/core/chunk_body_from.hpp>
 #include <boost/taar/core/async_generator.hpp>
 #include <boost/taar/core/is_async_generator.hpp>
 #include <boost/taar/core/chunked_response.hpp>
 #include <boost/taar/core/is_chunked_response.hpp>
-#include <boost/taar/core/cookies.hpp>
 #include <boost/taar/core/member_function_of.hpp>
 #include <boost/taar/core/cancellation_signals.hpp>
 #include <boost/taar/core/awaitable.hpp>
 #include <boost/taar/core/rebind_executor.hpp>
+#include <boost/taar/core/coalescing_stream.hpp>
+#include <boost/taar/core/timer_wheel.hpp>
+#include <boost/taar/core/streaming_body.hpp>
 #include <boost/taar/core/is_awaitable.hpp>
 #include <boost/taar/core/error.hpp>
 #include <boost/taar/type_traits/callable.hpp>
@@ -41,15 +47,30 @@
 #include <boost/beast/http/empty_body.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/beast/http/status.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/system/system_error.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/error.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/string.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/url/url_view.hpp>
 #include <functional>
 #include <type_traits>
+#include <concepts>
+#include <algorithm>
 #include <vector>
+#include <optional>
 #include <utility>
 #include <exception>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
+#include <limits>
+#include <array>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
 namespace boost::taar::session {
 namespace detail {
@@ -128,9 +149,9 @@ void apply_chunked_metadata(
     // For async_generator: no metadata to apply
 }
 
-template <typename T>
+template <typename T, typename ExecutorType>
 void apply_chunked_metadata(
-    chunked_response<T>& response,
+    chunked_response<T, ExecutorType>& response,
     ::boost::beast::http::response<::boost::beast::http::empty_body>& header)
 {
     namespace http = ::boost::beast::http;
@@ -158,8 +179,385 @@ constexpr auto chunked_value_type_helper()
 template <typename GeneratorType>
 using generator_value_t = typename decltype(chunked_value_type_helper<GeneratorType>())::type;
 
+// The I/O phases of a connection which have their own deadlines.
+enum class io_phase
+{
+    keep_alive,
+    header_read,
+    body_read,
+    write,
+};
+
+// Stream of an HTTP connection. Keeps the deadline of the current I/O phase
+// so a timeout can be attributed to the phase it expired in. When the
+// io_context of the executor is single threaded, e.g. created with a
+// concurrency hint of 1, the deadlines are armed on the timer wheel of the
+// io_context instead of the timers of the tcp_stream, and the stream is closed
+// when a deadline expires. Otherwise, e.g. on an io_context run by a thread
+// pool, the timers of the tcp_stream are used, which fail the operation in
+// progress with a timeout error.
+template <typename NextLayer>
+class http_stream : public coalescing_stream<NextLayer>
+{
+public:
+    using executor_type = typename coalescing_stream<NextLayer>::executor_type;
+
+    template <typename Arg>
+    http_stream(Arg&& arg, http_timeouts const& timeouts)
+        : coalescing_stream<NextLayer> {std::forward<Arg>(arg)}
+        , timeouts_ {timeouts}
+        , deadline_ {[this]
+            {
+                timed_out_ = true;
+                this->next_layer().close();
+            }}
+        , wheel_ {find_timer_wheel(this->get_executor())}
+    {}
+
+    http_stream(http_stream const&) = delete;
+    http_stream& operator=(http_stream const&) = delete;
+
+    template <
+        typename ConstBufferSequence,
+        typename WriteToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_write_some(
+        ConstBufferSequence const& buffers,
+        WriteToken&& token = WriteToken {})
+    {
+        return observe<WriteToken>(
+            [this, buffers](auto&& self)
+            {
+                // The buffers are part of self, which is moved.
+                auto const copy = buffers;
+                coalescing_stream<NextLayer>::async_write_some(
+                    copy,
+                    std::move(self));
+            },
+            std::forward<WriteToken>(token));
+    }
+
+    template <
+        typename MutableBufferSequence,
+        typename ReadToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_read_some(
+        MutableBufferSequence const& buffers,
+        ReadToken&& token = ReadToken {})
+    {
+        return observe<ReadToken>(
+            [this, buffers](auto&& self)
+            {
+                // The buffers are part of self, which is moved.
+                auto const copy = buffers;
+                coalescing_stream<NextLayer>::async_read_some(
+                    copy,
+                    std::move(self));
+            },
+            std::forward<ReadToken>(token));
+    }
+
+    template <
+        typename FlushToken =
+            boost::asio::default_completion_token_t<executor_type>>
+    auto async_flush(FlushToken&& token = FlushToken {})
+    {
+        return observe<FlushToken>(
+            [this](auto&& self)
+            {
+                coalescing_stream<NextLayer>::async_flush(std::move(self));
+            },
+            std::forward<FlushToken>(token));
+    }
+
+    // Starts the deadline of the phase for the next operations.
+    void expires_for(io_phase phase)
+    {
+        phase_ = phase;
+        auto const timeout = timeout_of(phase);
+        if (timeout == http_timeouts::duration::zero())
+        {
+            expires_never();
+        }
+        else if (wheel_)
+        {
+            wheel_->arm(deadline_, timeout);
+        }
+        else
+        {
+            this->next_layer().expires_after(timeout);
+        }
+    }
+
+    // Stops the deadline while the connection is not doing any I/O.
+    void expires_never()
+    {
+        if (wheel_)
+        {
+            deadline_.cancel();
+        }
+        else
+        {
+            this->next_layer().expires_never();
+        }
+    }
+
+    [[nodiscard]] io_phase phase() const noexcept
+    {
+        return phase_;
+    }
+
+    // Whether a deadline expired, either on the wheel or as a timeout error of
+    // an operation of the tcp_stream. Failing for any other reason, e.g. a
+    // reset connection, isn't a timeout even past the deadline.
+    [[nodiscard]] bool timed_out() const noexcept
+    {
+        return timed_out_;
+    }
+
+private:
+    // Runs an operation of the coalescing stream and notes whether it failed
+    // with the timeout error of the tcp_stream.
+    template <typename Token, typename Initiate>
+    auto observe(Initiate initiate, Token&& token)
+    {
+        return boost::asio::async_compose<
+            Token,
+            void(boost::system::error_code, std::size_t)>(
+                [this, initiate = std::move(initiate), started = false](
+                    auto& self,
+                    boost::system::error_code ec = {},
+                    std::size_t size = 0) mutable
+                {
+                    if (!std::exchange(started, true))
+                    {
+                        return initiate(std::move(self));
+                    }
+
+                    if (ec == boost::beast::error::timeout)
+                    {
+                        timed_out_ = true;
+                    }
+                    self.complete(ec, size);
+                },
+                std::forward<Token>(token),
+                this->next_layer());
+    }
+
+    http_timeouts::duration timeout_of(io_phase phase) const noexcept
+    {
+        switch (phase)
+        {
+        case io_phase::keep_alive: return timeouts_.keep_alive;
+        case io_phase::header_read: return timeouts_.header_read;
+        case io_phase::body_read: return timeouts_.body_read;
+        case io_phase::write: return timeouts_.write;
+        }
+
+        return http_timeouts::duration::zero();
+    }
+
+    http_timeouts timeouts_;
+    io_phase phase_ = io_phase::keep_alive;
+    bool timed_out_ = false;
+    timer_wheel::entry deadline_;
+    timer_wheel* wheel_;
+};
+
+inline void count_timeout(http_metrics& metrics, io_phase phase)
+{
+    switch (phase)
+    {
+    case io_phase::keep_alive: ++metrics.keep_alive_timeouts; break;
+    case io_phase::header_read: ++metrics.header_read_timeouts; break;
+    case io_phase::body_read: ++metrics.body_read_timeouts; break;
+    case io_phase::write: ++metrics.write_timeouts; break;
+    }
+}
+
+// Starts the deadline of the phase on an HTTP connection stream. No-op for the
+// other streams.
+template <typename StreamType>
+void expires_for(StreamType& stream, io_phase phase)
+{
+    if constexpr (requires { stream.expires_for(phase); })
+    {
+        stream.expires_for(phase);
+    }
+}
+
+// Stops the deadline of an HTTP connection stream. No-op for the other streams.
+template <typename StreamType>
+void expires_never(StreamType& stream)
+{
+    if constexpr (requires { stream.expires_never(); })
+    {
+        stream.expires_never();
+    }
+}
+
+// Sends the bytes held back by a coalescing stream to the client. No-op for
+// the other streams.
+template <typename ExecutorType = default_executor, typename StreamType>
+awaitable<bool, ExecutorType> flush_pending(StreamType& stream)
+{
+    if constexpr (requires { stream.pending_size(); })
+    {
+        if (stream.pending_size() != 0)
+        {
+            expires_for(stream, io_phase::write);
+            auto [ec, sz] = co_await stream.async_flush(
+                ::boost::asio::as_tuple(::boost::asio::deferred));
+            co_return !ec;
+        }
+    }
+
+    co_return true;
+}
+
+// Writes a stock response without a body. Returns whether the connection can
+// be kept alive.
+template <typename ExecutorType = default_executor, typename StreamType>
+awaitable<bool, ExecutorType> write_stock_response(
+    StreamType& stream,
+    ::boost::beast::http::status status,
+    unsigned version,
+    bool keep_alive)
+{
+    namespace http = ::boost::beast::http;
+    namespace net = ::boost::asio;
+
+    http::response<http::empty_body> response {status, version};
+    response.keep_alive(keep_alive);
+    response.prepare_payload();
+    expires_for(stream, io_phase::write);
+    auto [ec, sz] = co_await http::async_write(
+        stream,
+        response,
+        net::as_tuple(net::deferred));
+
+    co_return !ec && keep_alive;
+}
+
+// Yields the body of the request while it's read from the stream. Nothing is
+// read until the next chunk is requested. A read error ends the body with an
+// exception and is also kept in the read error, if any, e.g. so the session
+// can tell a body over the limit apart.
+template <typename ExecutorType = default_executor, typename StreamType>
+async_generator<streaming_body::chunk_type, ExecutorType> read_body_chunks(
+    StreamType& stream,
+    ::boost::beast::flat_buffer& buffer,
+    ::boost::beast::http::request_parser<::boost::beast::http::buffer_body>& parser,
+    boost::system::error_code* read_error = nullptr)
+{
+    namespace http = ::boost::beast::http;
+    namespace net = ::boost::asio;
+
+    std::array<std::byte, streaming_body::chunk_size> chunk;
+    while (!parser.is_done())
+    {
+        auto& body = parser.get().body();
+        body.data = chunk.data();
+        body.size = chunk.size();
+
+        expires_for(stream, io_phase::body_read);
+        auto [ec, sz] = co_await http::async_read_some(
+            stream,
+            buffer,
+            parser,
+            net::as_tuple(net::deferred));
+        expires_never(stream);
+
+        // The chunk is full.
+        if (ec == http::error::need_buffer)
+            ec = {};
+
+        if (ec)
+        {
+            if (read_error)
+                *read_error = ec;
+            throw boost::system::system_error {ec};
+        }
+
+        auto const size = chunk.size() - body.size;
+        if (size != 0)
+            co_yield streaming_body::chunk_type {chunk.data(), size};
+    }
+}
+
+// Whether the client waits for a 100 Continue before sending the body.
+inline bool expects_continue(::boost::beast::http::request_header<> const& header)
+{
+    return ::boost::beast::iequals(
+        header[::boost::beast::http::field::expect],
+        "100-continue");
+}
+
+// Writes an interim 100 Continue response right away.
+template <typename ExecutorType = default_executor, typename StreamType>
+awaitable<bool, ExecutorType> write_continue(StreamType& stream, unsigned version)
+{
+    namespace http = ::boost::beast::http;
+    namespace net = ::boost::asio;
+
+    http::response<http::empty_body> response {http::status::continue_, version};
+    expires_for(stream, io_phase::write);
+    auto [ec, sz] = co_await http::async_write(
+        stream,
+        response,
+        net::as_tuple(net::deferred));
+    if (ec)
+        co_return false;
+
+    // The client is waiting for it, so it can't be held back.
+    co_return co_await flush_pending<ExecutorType>(stream);
+}
+
+// Reads and drops the body of the request using a small scratch buffer, so it
+// never gets buffered. Returns false without draining the body if it's larger
+// than the limit, or on error, in which case the connection can't be reused.
+template <typename ExecutorType = default_executor, typename StreamType>
+awaitable<bool, ExecutorType> discard_body(
+    StreamType& stream,
+    ::boost::beast::flat_buffer& buffer,
+    ::boost::beast::http::request_parser<::boost::beast::http::buffer_body>& parser,
+    std::uint64_t limit)
+{
+    namespace http = ::boost::beast::http;
+    namespace net = ::boost::asio;
+
+    auto const content_length = parser.content_length();
+    if (content_length && *content_length > limit)
+        co_return false;
+
+    parser.body_limit(limit);
+    std::array<std::byte, 4096> scratch;
+    while (!parser.is_done())
+    {
+        auto& body = parser.get().body();
+        body.data = scratch.data();
+        body.size = scratch.size();
+
+        expires_for(stream, io_phase::body_read);
+        auto [ec, sz] = co_await http::async_read(
+            stream,
+            buffer,
+            parser,
+            net::as_tuple(net::deferred));
+
+        // The scratch buffer is full.
+        if (ec == http::error::need_buffer)
+            continue;
+
+        if (ec)
+            co_return false;
+    }
+
+    co_return true;
+}
+
 template <typename GeneratorType, typename StreamType>
-awaitable<bool> write_chunked_response(
+awaitable<bool, typename GeneratorType::executor_type> write_chunked_response(
     GeneratorType& generator,
     StreamType& stream,
     unsigned version,
@@ -169,6 +567,7 @@ awaitable<bool> write_chunked_response(
     namespace http = ::boost::beast::http;
     namespace net = ::boost::asio;
     using T = generator_value_t<GeneratorType>;
+    using executor_type = typename GeneratorType::executor_type;
 
     generator.set_executor(stream.get_executor());
     if (cancellation_slot.is_connected())
@@ -189,6 +588,7 @@ awaitable<bool> write_chunked_response(
     apply_chunked_metadata(generator, header_response);
 
     http::response_serializer<http::empty_body> serializer {header_response};
+    expires_for(stream, io_phase::write);
     auto [header_ec, header_sz] = co_await http::async_write_header(
         stream, serializer, net::as_tuple(net::deferred));
     if (header_ec)
@@ -198,6 +598,7 @@ awaitable<bool> write_chunked_response(
     if (first_value)
     {
         auto body = chunk_body_from(std::move(*first_value));
+        expires_for(stream, io_phase::write);
         auto [write_ec, write_sz] = co_await net::async_write(
             stream,
             http::make_chunk(net::buffer(body)),
@@ -205,24 +606,35 @@ awaitable<bool> write_chunked_response(
         if (write_ec)
             co_return false;
 
+        // Chunks are streamed to the client as soon as they are produced.
+        if (!co_await flush_pending<executor_type>(stream))
+            co_return false;
+
         // Send remaining chunks
         while (true)
         {
+            // Producing a chunk might take any time.
+            expires_never(stream);
             auto [ec, value] = co_await generator.next();
             if (!value)
                 break;
 
             auto chunk_body = chunk_body_from(std::move(*value));
+            expires_for(stream, io_phase::write);
             auto [chunk_ec, chunk_sz] = co_await net::async_write(
                 stream,
                 http::make_chunk(net::buffer(chunk_body)),
                 net::as_tuple(net::deferred));
             if (chunk_ec)
                 co_return false;
+
+            if (!co_await flush_pending<executor_type>(stream))
+                co_return false;
         }
     }
 
     // Send last chunk (best effort, ignore errors)
+    expires_for(stream, io_phase::write);
     co_await net::async_write(
         stream,
         http::make_chunk_last(),
@@ -233,20 +645,31 @@ awaitable<bool> write_chunked_response(
 
 } // detail
 
-class http
+// HTTP session of the connections accepted on ExecutorType, e.g. a strand per
+// connection on a thread pool. The handlers return awaitables of the same
+// executor type.
+template <typename ExecutorType = default_executor>
+class basic_http
 {
 private:
+    // Max number of bytes read at once while waiting for a request.
+    static constexpr std::size_t read_size_limit = 64 * 1024;
+
+    // Body limit of the routes without one, same as the default of Beast.
+    static constexpr std::uint64_t default_body_limit = 1024 * 1024;
+
+    using stream_type = detail::http_stream<
+        rebind_executor<boost::beast::tcp_stream, ExecutorType>>;
+
     using matcher_type = std::move_only_function<
         bool(
             boost::beast::http::request_header<> const&,
-            matcher::context&,
-            boost::urls::url_view const&,
-            cookies const&)>;
+            matcher::context&)>;
 
     using request_handler_wrapper_type = std::move_only_function<
-        awaitable<bool>(
+        awaitable<bool, ExecutorType>(
             matcher::context const&,
-            rebind_executor<boost::beast::tcp_stream>&,
+            stream_type&,
             boost::beast::flat_buffer&,
             boost::beast::http::request_parser<boost::beast::http::buffer_body>&,
             cancellation_signals&)>;
@@ -258,22 +681,22 @@ private:
     };
 
     using soft_error_handler_wrapper_type = std::move_only_function<
-        awaitable<bool>(
+        awaitable<bool, ExecutorType>(
             std::exception_ptr,
-            rebind_executor<boost::beast::tcp_stream>&,
+            stream_type&,
             boost::beast::http::request_header<>&,
             cancellation_signals&)>;
 
     using hard_error_handler_type = std::move_only_function<void(std::exception_ptr)>;
 
 public:
-    http()
+    basic_http()
         : wrapped_soft_error_handler_ {
             [](
                 std::exception_ptr eptr,
-                rebind_executor<boost::beast::tcp_stream>& stream,
+                stream_type& stream,
                 boost::beast::http::request_header<>& req,
-                cancellation_signals&) -> awaitable<bool>
+                cancellation_signals&) -> awaitable<bool, ExecutorType>
             {
                 std::exception_ptr ex;
                 std::string error_msg;
@@ -299,6 +722,7 @@ public:
                     auto response = response_from(error_msg);
                     response.result(boost::beast::http::status::bad_request);
                     bool keep_alive = response.keep_alive();
+                    stream.expires_for(detail::io_phase::write);
                     co_await detail::async_write(stream, std::move(response));
                     co_return keep_alive;
                 }
@@ -308,14 +732,14 @@ public:
         }
     {}
 
-    http(http const&) = delete;
-    http(http&&) = default;
-    http& operator=(http const&) = delete;
-    http& operator=(http&&) = default;
-    ~http() = default;
+    basic_http(basic_http const&) = delete;
+    basic_http(basic_http&&) = default;
+    basic_http& operator=(basic_http const&) = delete;
+    basic_http& operator=(basic_http&&) = default;
+    ~basic_http() = default;
 
-    awaitable<void> operator()(
-        rebind_executor<boost::asio::ip::tcp::socket> socket,
+    awaitable<void, ExecutorType> operator()(
+        rebind_executor<boost::asio::ip::tcp::socket, ExecutorType> socket,
         cancellation_signals& signals)
     {
         namespace net = boost::asio;
@@ -324,7 +748,27 @@ public:
         using boost::beast::tcp_stream;
         using boost::beast::flat_buffer;
 
-        rebind_executor<tcp_stream> stream {std::move(socket)};
+        stream_type stream {
+            rebind_executor<tcp_stream, ExecutorType> {std::move(socket)},
+            timeouts_};
+
+        // Request-scoped memory of the matchers and the handlers. The arena is
+        // released after each request into the pool of the connection which
+        // keeps the memory for the next requests.
+        std::pmr::unsynchronized_pool_resource connection_memory;
+        std::pmr::monotonic_buffer_resource request_memory {&connection_memory};
+
+        // Connection-scoped state which is reused by the requests of the
+        // connection. The buffer keeps its capacity and any bytes of the next
+        // requests which are already read.
+        flat_buffer buffer;
+        std::optional<http::request_parser<http::buffer_body>> header_parser;
+        matcher::router::route_list routes {&connection_memory};
+        matcher::context context {
+            .path_args = matcher::flat_path_args {
+                matcher::flat_path_args::allocator_type {&request_memory}},
+            .memory_resource = &request_memory};
+        std::size_t pipelined_responses = 0;
 
         try
         {
@@ -333,13 +777,47 @@ public:
                 cs = co_await this_coro::cancellation_state)
             {
                 // Read and parse the header and use the target to find the handler.
-                flat_buffer buffer;
-                http::request_parser<http::buffer_body> header_parser;
+                header_parser.emplace();
+
+                // The body limit is only known after the route is found.
+                header_parser->body_limit(std::numeric_limits<std::uint64_t>::max());
+                context.path_args.clear();
+                context.cache.clear();
+                request_memory.release();
 
+                if (buffer.size() == 0)
+                {
+                    // Nothing of the next request is read yet. Send the held
+                    // back responses and wait for the client while the
+                    // connection is idle.
+                    if (stream.pending_size() != 0)
+                    {
+                        pipelined_responses = 0;
+                        stream.expires_for(detail::io_phase::write);
+                        auto [flush_ec, flush_sz] = co_await stream.async_flush();
+                        if (flush_ec)
+                        {
+                            // Error in writing the responses. The session will be closed.
+                            break;
+                        }
+                    }
+
+                    stream.expires_for(detail::io_phase::keep_alive);
+                    auto [wait_ec, wait_sz] = co_await stream.async_read_some(
+                        buffer.prepare(boost::beast::read_size(buffer, read_size_limit)));
+                    buffer.commit(wait_sz);
+                    if (wait_ec)
+                    {
+                        // Error or timeout waiting for the request. Session will be closed.
+                        break;
+                    }
+                }
+
+                stream.expires_for(detail::io_phase::header_read);
                 auto [header_ec, header_sz] = co_await http::async_read_header(
                     stream,
                     buffer,
-                    header_parser);
+                    *header_parser);
 
                 if (header_ec)
                 {
@@ -347,93 +825,89 @@ public:
                     break;
                 }
 
-                auto& req_header = header_parser.get();
-                matcher::context context;
-                boost::urls::url_view parsed_target;
-                cookies parsed_cookies;
+                auto& req_header = header_parser->get();
 
-                if (needs_parsed_target_)
-                {
-                    parsed_target = boost::urls::url_view(req_header.target());
-                }
-
-                if (needs_parsed_cookies_)
-                {
-                    auto r = req_header.equal_range(boost::beast::http::field::cookie);
-                    for (; r.first != r.second; ++r.first)
-                    {
-                        parse_cookies(r.first->value(), parsed_cookies);
-                    }
-                }
-
-                auto iter = std::ranges::find_if(matcher_handlers_,
-                    [&](auto&& matcher_handler) -> bool
+                // The target is parsed once for the router and the matchers.
+                router_.lookup(
+                    req_header.method(),
+                    context.cache.find_parsed_target(req_header),
+                    routes);
+                auto iter = std::ranges::find_if(routes,
+                    [&](auto route) -> bool
                     {
                         context.path_args.clear();
-                        return matcher_handler.matcher(
-                            req_header,
-                            context,
-                            parsed_target,
-                            parsed_cookies);
+                        return matcher_handlers_[route].matcher(req_header, context);
                     });
 
-                if (iter != matcher_handlers_.cend())
+                if (iter != routes.cend())
                 {
-                    if (!co_await iter->handler(
+                    if (!co_await matcher_handlers_[*iter].handler(
                         context,
                         stream,
                         buffer,
-                        header_parser,
-                        signals))
+                        *header_parser,
+                        signals) || stream.timed_out())
                     {
-                        // Handler instructed to close the session.
+                        // Handler instructed to close the session or a deadline
+                        // expired while handling the request.
                         break;
                     }
-
-                    // Done with this request. Proceeding with the next one.
-                    continue;
                 }
-
-                // No handler found for this request. Reply with not found error.
-                // But before sending the error response, it is necessary to read
-                // the full buffer.
-                auto keep_alive = req_header.keep_alive();
-                auto version = req_header.version();
-                if (req_header.payload_size().has_value() &&
-                    req_header.payload_size().value() > 0)
+                else
                 {
-                    http::request_parser<http::string_body> body_parser {std::move(header_parser)};
-                    auto [req_ec, req_sz] = co_await async_read(
+                    // No handler found for this request. Reply with not found error.
+                    // But before sending the error response, the body is dropped
+                    // so the connection can be reused, unless it's too large to
+                    // be worth it.
+                    auto keep_alive = req_header.keep_alive();
+                    auto version = req_header.version();
+                    if (!header_parser->is_done() && detail::expects_continue(req_header))
+                    {
+                        // The client hasn't sent the body and waits for it to
+                        // be accepted.
+                        keep_alive = false;
+                    }
+                    else if (!co_await detail::discard_body<ExecutorType>(
                         stream,
                         buffer,
-                        body_parser);
+                        *header_parser,
+                        discard_limit_))
+                    {
+                        keep_alive = false;
+                    }
 
-                    if (req_ec)
+                    // Stock not-found response.
+                    if (stream.timed_out() || !co_await detail::write_stock_response<ExecutorType>(
+                        stream,
+                        http::status::not_found,
+                        version,
+                        keep_alive))
                     {
-                        // Error reading the full request. The session will be closed.
+                        // Error in writing the response or keep alive is not
+                        // possible. The session will be closed.
                         break;
                     }
-                    auto const& request = body_parser.get();
                 }
 
-                // Stock not-found response.
-                http::response<http::empty_body> response {http::status::not_found, version};
-                response.keep_alive(keep_alive);
-                response.prepare_payload();
-                auto [resp_ec, resp_sz] = co_await http::async_write(
-                    stream,
-                    response);
-
-                if (resp_ec)
+                // The responses are held back in the stream while the next
+                // pipelined requests are served from the buffer, and go out in a
+                // single write as soon as the session needs to read from the
+                // client again. Up to the max pipeline depth of responses are
+                // held back.
+                if (stream.pending_size() == 0)
                 {
-                    // Error in writing the response. The session will be closed.
-                    break;
+                    pipelined_responses = 0;
                 }
-
-                if (!keep_alive)
+                else if (++pipelined_responses >= max_pipeline_depth_)
                 {
-                    // Keep alive is not requested.
-                    break;
+                    pipelined_responses = 0;
+                    stream.expires_for(detail::io_phase::write);
+                    auto [flush_ec, flush_sz] = co_await stream.async_flush();
+                    if (flush_ec)
+                    {
+                        // Error in writing the responses. The session will be closed.
+                        break;
+                    }
                 }
             }
         }
@@ -443,9 +917,21 @@ public:
             hard_error_handler_(std::current_exception());
         }
 
+        if (stream.timed_out())
+        {
+            // The deadline of the current phase expired and the socket is
+            // already closed.
+            detail::count_timeout(*metrics_, stream.phase());
+            co_return;
+        }
+
+        // Write the responses which are still held back.
+        stream.expires_for(detail::io_phase::write);
+        co_await stream.async_flush();
+
         // Send a TCP shutdown
         boost::system::error_code ec;
-        stream.socket().shutdown(net::ip::tcp::socket::shutdown_send, ec); // NOLINT
+        stream.next_layer().socket().shutdown(net::ip::tcp::socket::shutdown_send, ec); // NOLINT
     }
 
     template <typename MatcherType, typename RequestHandler>
@@ -467,127 +953,270 @@ public:
         std::is_move_constructible_v<std::decay_t<RequestHandler>>)
     auto register_request_handler(
         MatcherType&& matcher,
-        RequestHandler request_handler)
+        RequestHandler request_handler,
+        route_options options = {})
     {
         namespace http = boost::beast::http;
 
         matcher::operand operand {std::forward<MatcherType>(matcher)};
-        needs_parsed_target_ |= decltype(operand)::with_parsed_target;
-        needs_parsed_cookies_ |= decltype(operand)::with_parsed_cookies;
+        router_.insert(operand.hint(), matcher_handlers_.size());
 
         matcher_handlers_.emplace_back(
             [this, operand = std::move(operand)](
                 http::request_header<> const& request,
-                matcher::context& context,
-                boost::urls::url_view const& parsed_target,
-                cookies const& parsed_cookies)
+                matcher::context& context)
             {
-                return operand(request, context, parsed_target, parsed_cookies);
+                return operand(request, context);
             },
-            [this, request_handler = std::move(request_handler)](
+            [this, request_handler = std::move(request_handler), options = std::move(options)](
                 matcher::context const& context,
-                rebind_executor<boost::beast::tcp_stream>& stream,
+                stream_type& stream,
                 boost::beast::flat_buffer& buffer,
                 boost::beast::http::request_parser<boost::beast::http::buffer_body>& header_parser,
                 cancellation_signals& signals) mutable
-            -> awaitable<bool>
+            -> awaitable<bool, ExecutorType>
             {
                 using request_type = std::remove_cvref_t<type_traits::callable_arg<RequestHandler, 0>>;
                 using body_type = request_type::body_type;
                 using result_type = type_traits::callable_result<RequestHandler>;
 
-                http::request_parser<body_type> body_parser {std::move(header_parser)};
-                auto [req_ec, req_sz] = co_await async_read(stream, buffer, body_parser);
-
-                auto version = body_parser.get().version();
-                auto keep_alive = body_parser.get().keep_alive();
-
-                // Get cancellation slot from current coroutine for request-scoped cancellation
-                auto cs = co_await boost::asio::this_coro::cancellation_state;
-                auto cancellation_slot = cs.slot();
+                // Reject a too large body before reading any of it. The
+                // connection is closed since the body is left unread.
+                auto const body_limit = options.body_limit.value_or(default_body_limit);
+                auto const content_length = header_parser.content_length();
+                if (content_length && *content_length > body_limit)
+                {
+                    co_return co_await detail::write_stock_response<ExecutorType>(
+                        stream,
+                        http::status::payload_too_large,
+                        header_parser.get().version(),
+                        false);
+                }
 
-                std::exception_ptr eptr;
-                try
+                // Route admission on the header alone. The connection is only
+                // kept alive if there's no body left unread.
+                if (options.admission)
                 {
-                    if constexpr (is_chunked_response<result_type>)
+                    if (auto const status = options.admission(header_parser.get(), context))
                     {
-                        // Sync handler returning chunked_response<T>
-                        auto generator = std::invoke(
-                            std::move(request_handler),
-                            body_parser.get(),
-                            context);
-                        co_return co_await detail::write_chunked_response(
-                            generator, stream, version, keep_alive, cancellation_slot);
+                        co_return co_await detail::write_stock_response<ExecutorType>(
+                            stream,
+                            *status,
+                            header_parser.get().version(),
+                            header_parser.get().keep_alive() && header_parser.is_done());
                     }
-                    else if constexpr (is_async_generator<result_type>)
+                }
+
+                // The body is accepted. A client expecting 100 Continue waits
+                // for it before sending the body, unless the handler doesn't
+                // take a body at all.
+                bool const expects_continue =
+                    !header_parser.is_done() &&
+                    detail::expects_continue(header_parser.get());
+                if constexpr (!std::same_as<body_type, http::empty_body>)
+                {
+                    if (expects_continue &&
+                        !co_await detail::write_continue<ExecutorType>(stream, header_parser.get().version()))
                     {
-                        // Sync handler returning async_generator<T>
-                        auto generator = std::invoke(
-                            std::move(request_handler),
-                            body_parser.get(),
-                            context);
-                        co_return co_await detail::write_chunked_response(
-                            generator, stream, version, keep_alive, cancellation_slot);
+                        co_return false;
                     }
-                    else if constexpr (is_awaitable<result_type>)
+                }
+
+                // Error of reading a body which is streamed to the handler.
+                boost::system::error_code body_ec;
+
+                // Invokes the handler and writes its response. Returns whether the
+                // connection can be kept alive.
+                auto invoke_handler = [&](auto& request) -> awaitable<bool, ExecutorType>
+                {
+                    auto version = request.version();
+                    auto keep_alive = request.keep_alive();
+
+                    // The handler only got a part of a streamed body which
+                    // crossed the limit, so its response is replaced.
+                    auto const body_too_large = [&]
+                    {
+                        return body_ec == http::error::body_limit;
+                    };
+                    auto const write_body_too_large = [&]
                     {
-                        if constexpr (is_chunked_response<typename result_type::value_type>)
+                        return detail::write_stock_response<ExecutorType>(
+                            stream,
+                            http::status::payload_too_large,
+                            version,
+                            false);
+                    };
+
+                    // Get cancellation slot from current coroutine for request-scoped cancellation
+                    auto cs = co_await boost::asio::this_coro::cancellation_state;
+                    auto cancellation_slot = cs.slot();
+
+                    std::exception_ptr eptr;
+                    try
+                    {
+                        if constexpr (is_chunked_response<result_type>)
                         {
-                            // Async handler returning awaitable<chunked_response<T>>
-                            auto generator = co_await std::invoke(
+                            // Sync handler returning chunked_response<T>
+                            auto generator = std::invoke(
                                 std::move(request_handler),
-                                body_parser.get(),
+                                request,
                                 context);
                             co_return co_await detail::write_chunked_response(
                                 generator, stream, version, keep_alive, cancellation_slot);
                         }
-                        else if constexpr (is_async_generator<typename result_type::value_type>)
+                        else if constexpr (is_async_generator<result_type>)
                         {
-                            // Async handler returning awaitable<async_generator<T>>
-                            auto generator = co_await std::invoke(
+                            // Sync handler returning async_generator<T>
+                            auto generator = std::invoke(
                                 std::move(request_handler),
-                                body_parser.get(),
+                                request,
                                 context);
                             co_return co_await detail::write_chunked_response(
                                 generator, stream, version, keep_alive, cancellation_slot);
                         }
+                        else if constexpr (is_awaitable<result_type>)
+                        {
+                            if constexpr (is_chunked_response<typename result_type::value_type>)
+                            {
+                                // Async handler returning awaitable<chunked_response<T>>
+                                auto generator = co_await std::invoke(
+                                    std::move(request_handler),
+                                    request,
+                                    context);
+                                co_return co_await detail::write_chunked_response(
+                                    generator, stream, version, keep_alive, cancellation_slot);
+                            }
+                            else if constexpr (is_async_generator<typename result_type::value_type>)
+                            {
+                                // Async handler returning awaitable<async_generator<T>>
+                                auto generator = co_await std::invoke(
+                                    std::move(request_handler),
+                                    request,
+                                    context);
+                                co_return co_await detail::write_chunked_response(
+                                    generator, stream, version, keep_alive, cancellation_slot);
+                            }
+                            else
+                            {
+                                // Existing awaitable path
+                                auto response = co_await response_from_invoke<ExecutorType>(
+                                    std::move(request_handler),
+                                    request,
+                                    context);
+                                if (body_too_large())
+                                {
+                                    co_return co_await write_body_too_large();
+                                }
+
+                                bool keep_alive = response.keep_alive();
+                                stream.expires_for(detail::io_phase::write);
+                                co_await detail::async_write(stream, std::move(response));
+                                co_return keep_alive;
+                            }
+                        }
                         else
                         {
-                            // Existing awaitable path
-                            auto response = co_await response_from_invoke(
+                            // Existing path: response_from_invoke -> async_write
+                            auto response = co_await response_from_invoke<ExecutorType>(
                                 std::move(request_handler),
-                                body_parser.get(),
+                                request,
                                 context);
+                            if (body_too_large())
+                            {
+                                co_return co_await write_body_too_large();
+                            }
 
                             bool keep_alive = response.keep_alive();
+                            stream.expires_for(detail::io_phase::write);
                             co_await detail::async_write(stream, std::move(response));
                             co_return keep_alive;
                         }
                     }
-                    else
+                    catch (...)
+                    {
+                        eptr = std::current_exception();
+                    }
+
+                    if (body_too_large())
+                    {
+                        co_return co_await write_body_too_large();
+                    }
+
+                    // An exception is thrown within the request handler.
+                    co_return co_await wrapped_soft_error_handler_(
+                        eptr,
+                        stream,
+                        request,
+                        signals);
+                };
+
+                if constexpr (std::same_as<body_type, http::empty_body>)
+                {
+                    // A body sent to a handler which doesn't take one is dropped.
+                    // If it's too large to be dropped or the client is still
+                    // waiting to send it, the connection is closed after the
+                    // response.
+                    bool drained = false;
+                    if (!expects_continue)
+                    {
+                        drained = co_await detail::discard_body<ExecutorType>(
+                            stream,
+                            buffer,
+                            header_parser,
+                            std::min(body_limit, discard_limit_));
+                    }
+
+                    if (stream.timed_out())
                     {
-                        // Existing path: response_from_invoke -> async_write
-                        auto response = co_await response_from_invoke(
-                            std::move(request_handler),
-                            body_parser.get(),
-                            context);
-
-                        bool keep_alive = response.keep_alive();
-                        co_await detail::async_write(stream, std::move(response));
-                        co_return keep_alive;
+                        co_return false;
                     }
+
+                    stream.expires_never();
+                    request_type request {std::move(header_parser.release().base())};
+                    auto const keep_alive = co_await invoke_handler(request);
+                    co_return keep_alive && drained;
                 }
-                catch (...)
+                else if constexpr (std::same_as<body_type, basic_streaming_body<ExecutorType>>)
                 {
-                    eptr = std::current_exception();
+                    // The body is read while the handler consumes it.
+                    header_parser.body_limit(body_limit);
+                    request_type request {header_parser.get().base()};
+                    request.body() = detail::read_body_chunks<ExecutorType>(
+                        stream,
+                        buffer,
+                        header_parser,
+                        &body_ec);
+                    auto const keep_alive = co_await invoke_handler(request);
+
+                    // The connection can't be reused unless the whole body is read.
+                    co_return keep_alive && header_parser.is_done();
                 }
+                else
+                {
+                    http::request_parser<body_type> body_parser {std::move(header_parser)};
+                    body_parser.body_limit(body_limit);
+                    stream.expires_for(detail::io_phase::body_read);
+                    auto [req_ec, req_sz] = co_await async_read(stream, buffer, body_parser);
+                    if (req_ec == http::error::body_limit)
+                    {
+                        // A chunked body grew beyond the limit.
+                        co_return co_await detail::write_stock_response<ExecutorType>(
+                            stream,
+                            http::status::payload_too_large,
+                            body_parser.get().version(),
+                            false);
+                    }
 
-                // An exception is thrown within the request handler.
-                co_return co_await wrapped_soft_error_handler_(
-                    eptr,
-                    stream,
-                    body_parser.get(),
-                    signals);
+                    if (req_ec)
+                    {
+                        // Error reading the full request. The session will be closed.
+                        co_return false;
+                    }
+
+                    // The handler might take any time to produce the response.
+                    stream.expires_never();
+                    co_return co_await invoke_handler(body_parser.get());
+                }
             }
         );
     }
@@ -596,14 +1225,16 @@ public:
     auto register_request_handler(
         MatcherType&& matcher,
         ResultType(ObjectType::*memfn)(ArgsType...),
-        ObjectType* object)
+        ObjectType* object,
+        route_options options = {})
     {
         return register_request_handler(
             std::forward<MatcherType>(matcher),
             [memfn, object](ArgsType&&... args) mutable
             {
                 return (object->*memfn)(std::forward<ArgsType>(args)...);
-            }
+            },
+            std::move(options)
         );
     }
 
@@ -611,14 +1242,16 @@ public:
     auto register_request_handler(
         MatcherType&& matcher,
         ResultType(ObjectType::*memfn)(ArgsType...) const,
-        ObjectType const* object)
+        ObjectType const* object,
+        route_options options = {})
     {
         return register_request_handler(
             std::forward<MatcherType>(matcher),
             [memfn, object](ArgsType&&... args)
             {
                 return (object->*memfn)(std::forward<ArgsType>(args)...);
-            }
+            },
+            std::move(options)
         );
     }
 
@@ -628,13 +1261,14 @@ public:
         wrapped_soft_error_handler_ =
             [handler = std::move(handler)](
                 std::exception_ptr eptr,
-                rebind_executor<boost::beast::tcp_stream>& stream,
+                stream_type& stream,
                 boost::beast::http::request_header<>& request_header,
                 cancellation_signals& signals) mutable
-            -> awaitable<bool>
+            -> awaitable<bool, ExecutorType>
             {
-                auto response = co_await response_from_invoke(handler, eptr);
+                auto response = co_await response_from_invoke<ExecutorType>(handler, eptr);
                 bool keep_alive = response.keep_alive();
+                stream.expires_for(detail::io_phase::write);
                 co_await detail::async_write(stream, std::move(response));
                 co_return keep_alive;
             };
@@ -646,14 +1280,50 @@ public:
         hard_error_handler_ = std::move(handler);
     }
 
+    // Deadlines of the connections accepted after the call.
+    void set_timeouts(http_timeouts const& timeouts)
+    {
+        timeouts_ = timeouts;
+    }
+
+    [[nodiscard]] http_timeouts const& timeouts() const noexcept
+    {
+        return timeouts_;
+    }
+
+    [[nodiscard]] http_metrics const& metrics() const noexcept
+    {
+        return *metrics_;
+    }
+
+    // Max size of a request body which is read and dropped to keep the
+    // connection alive, e.g. the body of a request without a handler. The
+    // connection is closed instead of reading a larger body.
+    void set_discard_limit(std::uint64_t limit)
+    {
+        discard_limit_ = limit;
+    }
+
+    // Max number of responses to pipelined requests which are coalesced into
+    // a single write. One writes every response as soon as it is ready.
+    void set_max_pipeline_depth(std::size_t depth)
+    {
+        max_pipeline_depth_ = std::max<std::size_t>(depth, 1);
+    }
+
 private:
     std::vector<matcher_handler_type> matcher_handlers_;
+    matcher::router router_;
     soft_error_handler_wrapper_type wrapped_soft_error_handler_;
     hard_error_handler_type hard_error_handler_ = [](std::exception_ptr){};
-    bool needs_parsed_target_ = false;
-    bool needs_parsed_cookies_ = false;
+    std::size_t max_pipeline_depth_ = 16;
+    std::uint64_t discard_limit_ = 64 * 1024;
+    http_timeouts timeouts_;
+    std::unique_ptr<http_metrics> metrics_ = std::make_unique<http_metrics>();
 };
 
+using http = basic_http<>;
+
 } // namespace boost::taar::session
 
 #endif // BOOST_TAAR_SESSION_HTTP_HPP
@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SESSION_HTTP_METRICS_HPP
+#define BOOST_TAAR_SESSION_HTTP_METRICS_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace boost::taar::session {
+
+// Counters of an HTTP session, shared by all of its connections which might
+// be served by different threads.
+struct http_metrics
+{
+    // Connections closed because their deadlines expired.
+    std::atomic<std::uint64_t> keep_alive_timeouts {0};
+    std::atomic<std::uint64_t> header_read_timeouts {0};
+    std::atomic<std::uint64_t> body_read_timeouts {0};
+    std::atomic<std::uint64_t> write_timeouts {0};
+};
+
+} // namespace boost::taar::session
+
+#endif // BOOST_TAAR_SESSION_HTTP_METRICS_HPP
@@ -0,0 +1,38 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SESSION_HTTP_TIMEOUTS_HPP
+#define BOOST_TAAR_SESSION_HTTP_TIMEOUTS_HPP
+
+#include <chrono>
+
+namespace boost::taar::session {
+
+// Deadlines of the I/O of an HTTP connection. The connection is closed when a
+// deadline expires. A zero duration disables the deadline.
+struct http_timeouts
+{
+    using duration = std::chrono::steady_clock::duration;
+
+    // Waiting for the first byte of the next request on an idle connection.
+    duration keep_alive = std::chrono::seconds {15};
+
+    // Reading the whole header of a request.
+    duration header_read = std::chrono::seconds {30};
+
+    // Reading the whole body of a request.
+    duration body_read = std::chrono::seconds {60};
+
+    // Writing a response, or each chunk of a chunked response.
+    duration write = std::chrono::seconds {30};
+};
+
+} // namespace boost::taar::session
+
+#endif // BOOST_TAAR_SESSION_HTTP_TIMEOUTS_HPP
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#ifndef BOOST_TAAR_SESSION_ROUTE_OPTIONS_HPP
+#define BOOST_TAAR_SESSION_ROUTE_OPTIONS_HPP
+
+#include <boost/taar/matcher/context.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/status.hpp>
+#include <functional>
+#include <optional>
+#include <cstdint>
+
+namespace boost::taar::session {
+
+// Policies of a request handler which are applied by the session before the
+// handler is invoked.
+struct route_options
+{
+    // Max size of the request body in bytes. A request with a larger
+    // Content-Length is rejected with 413 before its body is read, and a
+    // chunked body is rejected as soon as it grows beyond the limit. The
+    // default limit of Beast for requests is used if it's not set.
+    std::optional<std::uint64_t> body_limit;
+
+    // Admission check of the request header (e.g. authorization or content
+    // type) which runs before the body is read. The request is rejected with
+    // the returned status, or accepted if it returns nothing. For a request
+    // with "Expect: 100-continue" the client only uploads the body once it's
+    // accepted.
+    std::function<std::optional<boost::beast::http::status>(
+        boost::beast::http::request_header<> const&,
+        matcher::context const&)> admission;
+};
+
+} // namespace boost::taar::session
+
+#endif // BOOST_TAAR_SESSION_ROUTE_OPTIONS_HPP
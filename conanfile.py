@@ -1,7 +1,7 @@
 import os
 from conan import ConanFile
 from conan.tools.files import copy
-from conan.tools.cmake import cmake_layout, CMake
+from conan.tools.cmake import cmake_layout, CMake, CMakeToolchain
 from conan.tools.build import check_min_cppstd
 
 class BoostTaarConan(ConanFile):
@@ -13,6 +13,11 @@ class BoostTaarConan(ConanFile):
     description = "A header-only library for web server and client development"
     topics = ("boost", "asio", "beast", "http", "network", "web", "taar")
     settings = "os", "arch", "compiler", "build_type"
+    # Number of coroutine frames Boost.Asio recycles per thread. It must be the
+    # same in the whole program, so it's only defined for the consumers which
+    # ask for it.
+    options = {"frame_cache_size": [None, "ANY"]}
+    default_options = {"frame_cache_size": None}
     exports_sources = [
         "boost/*",
         "cmake/*",
@@ -22,7 +27,7 @@ class BoostTaarConan(ConanFile):
         "LICENSE",
         "README.md"]
     no_copy_source = True
-    generators = "CMakeToolchain", "CMakeDeps"
+    generators = "CMakeDeps"
 
     def requirements(self):
         self.requires("boost/1.86.0")
@@ -33,6 +38,12 @@ class BoostTaarConan(ConanFile):
     def layout(self):
         cmake_layout(self)
 
+    def generate(self):
+        toolchain = CMakeToolchain(self)
+        if self.options.frame_cache_size:
+            toolchain.cache_variables["BOOST_TAAR_FRAME_CACHE_SIZE"] = str(self.options.frame_cache_size)
+        toolchain.generate()
+
     def build(self):
         cmake = CMake(self)
         cmake.configure()
@@ -48,6 +59,9 @@ class BoostTaarConan(ConanFile):
         self.cpp_info.bindirs = []
         self.cpp_info.libdirs = []
         self.cpp_info.includedirs = ["include"]
+        if self.options.frame_cache_size:
+            self.cpp_info.defines = [
+                f"BOOST_ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE={self.options.frame_cache_size}"]
 
     def package_id(self):
         self.info.clear()
@@ -20,7 +20,6 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/signal_set.hpp>
-#include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/json/value.hpp>
 #include <filesystem>
@@ -73,13 +72,14 @@ int main(int argc, char* argv[])
     namespace http = boost::beast::http;
     namespace taar = boost::taar;
     using net::co_spawn;
-    using net::bind_cancellation_slot;
     using net::detached;
     using taar::response_builder;
     using taar::matcher::method;
     using taar::matcher::target;
     using taar::matcher::context;
 
+    // Run by a pool of threads, so the connections use the timers of their
+    // streams rather than the timer wheel, which needs a single thread.
     net::io_context io_context;
 
     net::signal_set os_signals(io_context, SIGINT, SIGTERM);
@@ -181,7 +181,7 @@ int main(int argc, char* argv[])
             {
                 std::clog << "HTTP server is listening on port " << endpoint.port() << '\n';
             }),
-        bind_cancellation_slot(cancellation_signals.slot(), taar::ignore_and_rethrow));
+        cancellation_signals.bind(taar::ignore_and_rethrow));
 
     std::vector<std::jthread> threads;
     for (int i = 0; i < 8; ++i)
@@ -23,7 +23,6 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/signal_set.hpp>
-#include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/json/value.hpp>
 #include <boost/json/value_from.hpp>
@@ -62,7 +61,6 @@ int main(int argc, char* argv[])
     namespace http = boost::beast::http;
     namespace taar = boost::taar;
     using net::co_spawn;
-    using net::bind_cancellation_slot;
     using net::detached;
     using taar::response_builder;
     using taar::matcher::method;
@@ -157,7 +155,7 @@ int main(int argc, char* argv[])
                 request.version()};
             res.set(boost::beast::http::field::content_type, "text/html");
             res.keep_alive(request.keep_alive());
-            res.body() = "Special path is: " + context.path_args.at("path");
+            res.body() = "Special path is: " + std::string {context.path_args.at("path")};
             res.prepare_payload();
             return res;
         }
@@ -321,7 +319,7 @@ int main(int argc, char* argv[])
             {
                 std::clog << "HTTP server is listening on port " << endpoint.port() << '\n';
             }),
-        bind_cancellation_slot(cancellation_signals.slot(), taar::ignore_and_rethrow));
+        cancellation_signals.bind(taar::ignore_and_rethrow));
 
     io_context.run();
 
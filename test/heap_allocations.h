@@ -0,0 +1,14 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <cstddef>
+
+// Number of heap allocations of the calling thread. Counted by the global
+// operator new of the tests, which is replaced in test_frame_allocator.cpp.
+extern thread_local std::size_t heap_allocations;
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/core/cancellation_signals.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+
+namespace {
+
+using boost::taar::cancellation_signals;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(test_cancellation_signals)
+{
+    namespace net = boost::asio;
+
+    net::io_context ioc;
+    cancellation_signals signals;
+
+    net::steady_timer timer {ioc, 1h};
+    boost::system::error_code timer_ec;
+    timer.async_wait(signals.bind(
+        [&](boost::system::error_code ec)
+        {
+            timer_ec = ec;
+        }));
+
+    ioc.poll();
+    signals.emit();
+    ioc.run();
+
+    BOOST_TEST(timer_ec == net::error::operation_aborted);
+}
+
+BOOST_AUTO_TEST_CASE(test_cancellation_signals_reuse)
+{
+    // Binding more tokens than the pool can hold at once doesn't run out of
+    // signals as each of them goes back to the pool with its handler.
+    cancellation_signals signals {1};
+    auto const capacity = cancellation_signals::chunk_size * cancellation_signals::max_chunks;
+    for (std::size_t count = 0; count != capacity + 1; ++count)
+    {
+        std::ignore = signals.bind([](boost::system::error_code){});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cancellation_signals_slot_reuse)
+{
+    namespace net = boost::asio;
+
+    // A reserved slot without a handler is handed out again, so asking for
+    // more slots than the pool can hold doesn't run out of signals.
+    cancellation_signals signals {1};
+    auto const capacity = cancellation_signals::chunk_size * cancellation_signals::max_chunks;
+    for (std::size_t count = 0; count != capacity + 1; ++count)
+    {
+        std::ignore = signals.slot();
+    }
+
+    // A slot in use isn't handed out until its handler is gone.
+    net::io_context ioc;
+    net::steady_timer timer {ioc, 1h};
+    auto const first = signals.slot();
+    boost::system::error_code timer_ec;
+    timer.async_wait(net::bind_cancellation_slot(
+        first,
+        [&](boost::system::error_code ec)
+        {
+            timer_ec = ec;
+        }));
+    BOOST_TEST(first.has_handler());
+    BOOST_TEST((signals.slot() != first));
+
+    ioc.poll();
+    signals.emit();
+    ioc.run();
+    BOOST_TEST(timer_ec == net::error::operation_aborted);
+    BOOST_TEST(!first.has_handler());
+    BOOST_TEST((signals.slot() == first));
+}
+
+BOOST_AUTO_TEST_CASE(test_cancellation_signals_concurrent)
+{
+    namespace net = boost::asio;
+
+    cancellation_signals signals {4};
+
+    // The signals are acquired and released concurrently and the completed
+    // operations don't receive the emitted cancellation.
+    std::array<int, 4> completed {};
+    std::vector<std::jthread> threads;
+    for (auto& count : completed)
+    {
+        threads.emplace_back([&]
+        {
+            net::io_context ioc;
+            for (int i = 0; i != 1000; ++i)
+            {
+                net::steady_timer timer {ioc, 0ms};
+                timer.async_wait(signals.bind([&](boost::system::error_code ec)
+                {
+                    count += !ec;
+                }));
+                ioc.restart();
+                ioc.run();
+            }
+        });
+    }
+    threads.clear();
+
+    signals.emit();
+    for (auto count : completed)
+    {
+        BOOST_TEST(count == 1000);
+    }
+}
+
+} // namespace
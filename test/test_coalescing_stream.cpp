@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/core/coalescing_stream.hpp>
+#include <boost/taar/core/awaitable.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/as_tuple.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+namespace {
+
+using boost::taar::coalescing_stream;
+using boost::taar::awaitable;
+
+BOOST_AUTO_TEST_CASE(test_coalescing_stream)
+{
+    namespace net = boost::asio;
+    using boost::beast::test::stream;
+
+    net::io_context ioc;
+    stream local {ioc};
+    stream remote {ioc};
+    local.connect(remote);
+
+    coalescing_stream<stream&> coalesced {local, 8};
+    bool completed = false;
+
+    net::co_spawn(ioc,
+        [&]() -> awaitable<void>
+        {
+            auto const token = net::as_tuple(net::deferred);
+
+            // Small writes are held back.
+            auto [ec1, sz1] = co_await coalesced.async_write_some(net::buffer("abc", 3), token);
+            BOOST_TEST(!ec1);
+            BOOST_TEST(sz1 == 3u);
+            auto [ec2, sz2] = co_await coalesced.async_write_some(net::buffer("de", 2), token);
+            BOOST_TEST(!ec2);
+            BOOST_TEST(sz2 == 2u);
+            BOOST_TEST(coalesced.pending_size() == 5u);
+            BOOST_TEST(remote.str() == "");
+
+            // Exceeding the capacity flushes the pending bytes first.
+            auto [ec3, sz3] = co_await coalesced.async_write_some(net::buffer("fghijk", 6), token);
+            BOOST_TEST(!ec3);
+            BOOST_TEST(sz3 == 6u);
+            BOOST_TEST(coalesced.pending_size() == 0u);
+            BOOST_TEST(remote.str() == "abcdefghijk");
+
+            // Reading flushes the pending bytes.
+            auto [ec4, sz4] = co_await coalesced.async_write_some(net::buffer("x", 1), token);
+            BOOST_TEST(!ec4);
+            BOOST_TEST(remote.str() == "abcdefghijk");
+            local.append("y");
+            char data[4];
+            auto [ec5, sz5] = co_await coalesced.async_read_some(net::buffer(data), token);
+            BOOST_TEST(!ec5);
+            BOOST_TEST(std::string(data, sz5) == "y");
+            BOOST_TEST(remote.str() == "abcdefghijkx");
+
+            // Explicit flush.
+            auto [ec6, sz6] = co_await coalesced.async_write_some(net::buffer("z", 1), token);
+            BOOST_TEST(!ec6);
+            auto [ec7, sz7] = co_await coalesced.async_flush(token);
+            BOOST_TEST(!ec7);
+            BOOST_TEST(sz7 == 1u);
+            BOOST_TEST(coalesced.pending_size() == 0u);
+            BOOST_TEST(remote.str() == "abcdefghijkxz");
+
+            completed = true;
+        },
+        [](std::exception_ptr ep)
+        {
+            if (ep) std::rethrow_exception(ep);
+        });
+
+    ioc.run();
+    BOOST_TEST(completed);
+}
+
+} // namespace
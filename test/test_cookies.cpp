@@ -9,6 +9,7 @@
 
 #include <boost/taar/core/cookies.hpp>
 #include <boost/test/unit_test.hpp>
+#include <string>
 
 namespace {
 
@@ -85,4 +86,49 @@ BOOST_AUTO_TEST_CASE(test_cookies_parser)
     BOOST_TEST(c1.at("W") == "Z");
 }
 
+BOOST_AUTO_TEST_CASE(test_cookies_view)
+{
+    using namespace boost::taar;
+
+    std::string const header1 = R"(session=10; name%31="a%20b";session=20)";
+    std::string const header2 = "plain=value; bad=va lue; ignored=1";
+
+    cookies_view view;
+    BOOST_TEST(view.empty());
+    BOOST_TEST((view.append(header1) == error::success));
+    BOOST_TEST((view.append(header2) == error::invalid_cookie_format));
+    BOOST_TEST(view.size() == 4);
+
+    // The first cookie with a name wins and the values refer to the headers.
+    auto const session = view.find("session");
+    BOOST_REQUIRE(session != view.end());
+    BOOST_TEST(view.value(*session) == "10");
+    BOOST_TEST(view.value(*session).data() == header1.data() + 8);
+
+    // Names and values are decoded only when needed.
+    auto const name1 = view.find("name1");
+    BOOST_REQUIRE(name1 != view.end());
+    BOOST_TEST(name1->encoded_name() == "name%31");
+    BOOST_TEST(name1->encoded_value() == "a%20b");
+    BOOST_TEST(view.value(*name1) == "a b");
+
+    BOOST_TEST(view.contains("plain"));
+    BOOST_TEST(!view.contains("bad"));
+    BOOST_TEST(!view.contains("ignored"));
+
+    // Conversions from and to the owning cookies.
+    cookies const jar {view};
+    BOOST_TEST(jar.size() == 3);
+    BOOST_TEST(jar.at("session") == "10");
+    BOOST_TEST(jar.at("name1") == "a b");
+
+    cookies_view const jar_view {jar};
+    BOOST_TEST(jar_view.size() == 3);
+    BOOST_TEST(jar_view.value(*jar_view.find("name1")) == "a b");
+
+    cookies_view const copy {view};
+    BOOST_TEST(copy.size() == 4);
+    BOOST_TEST(copy.value(*copy.find("name1")) == "a b");
+}
+
 } // namespace
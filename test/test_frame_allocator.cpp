@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/core/frame_allocator.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <new>
+#include "heap_allocations.h"
+
+thread_local std::size_t heap_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++heap_allocations;
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace {
+
+using boost::taar::frame_allocator;
+
+BOOST_AUTO_TEST_CASE(test_frame_allocator)
+{
+    auto const before = frame_allocator::thread_statistics();
+
+    auto* first = frame_allocator::allocate(100);
+    frame_allocator::deallocate(first, 100);
+
+    // The same size class gets the cached frame back.
+    auto* second = frame_allocator::allocate(120);
+    BOOST_TEST(second == first);
+    frame_allocator::deallocate(second, 120);
+
+    // Frames larger than the largest class aren't cached.
+    auto* large = frame_allocator::allocate(frame_allocator::max_size + 1);
+    frame_allocator::deallocate(large, frame_allocator::max_size + 1);
+
+    auto const& after = frame_allocator::thread_statistics();
+    BOOST_TEST(after.allocations - before.allocations == 3u);
+    BOOST_TEST(after.recycled - before.recycled == 1u);
+    BOOST_TEST(after.deallocations - before.deallocations == 3u);
+    BOOST_TEST(after.cached - before.cached == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_allocator_bounded)
+{
+    void* frames[frame_allocator::max_cached + 1];
+    for (auto& frame : frames)
+    {
+        frame = frame_allocator::allocate(frame_allocator::min_size);
+    }
+
+    auto const before = frame_allocator::thread_statistics();
+    for (auto* frame : frames)
+    {
+        frame_allocator::deallocate(frame, frame_allocator::min_size);
+    }
+
+    // At most max_cached frames are kept per size class.
+    auto const& after = frame_allocator::thread_statistics();
+    BOOST_TEST(after.cached - before.cached <= frame_allocator::max_cached);
+    BOOST_TEST(after.deallocations - before.deallocations == frame_allocator::max_cached + 1);
+}
+
+} // namespace
@@ -14,9 +14,37 @@
 #include <boost/taar/matcher/target.hpp>
 #include <boost/taar/core/response_builder.hpp>
 #include <boost/taar/core/async_generator.hpp>
+#include <boost/taar/core/chunked_response.hpp>
+#include <boost/taar/core/frame_allocator.hpp>
 #include <boost/taar/core/awaitable.hpp>
+#include <boost/taar/core/streaming_body.hpp>
+#include <boost/taar/core/cancellation_signals.hpp>
+#include <boost/taar/core/rebind_executor.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/as_tuple.hpp>
+#include <boost/asio/deferred.hpp>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <memory_resource>
+#include <new>
+#include "heap_allocations.h"
 
 namespace {
 
@@ -52,6 +80,62 @@ struct object_type
 void on_hard_error(int, std::exception_ptr)
 {}
 
+// Serves a single connection with the session on another thread while the
+// client talks to it over the loopback interface. The session ends once the
+// client is done and closes the connection. A concurrency hint other than 1
+// makes the session fall back to the timers of tcp_stream.
+void serve_connection(
+    taar::session::http& http_session,
+    std::function<void(boost::asio::ip::tcp::socket&)> const& client,
+    int concurrency_hint = 1)
+{
+    namespace net = boost::asio;
+
+    net::io_context ioc {concurrency_hint};
+    taar::cancellation_signals signals;
+    taar::rebind_executor<net::ip::tcp::acceptor> acceptor {
+        ioc,
+        {net::ip::make_address("127.0.0.1"), 0}};
+    auto const endpoint = acceptor.local_endpoint();
+    net::co_spawn(ioc,
+        [&]() -> taar::awaitable<void>
+        {
+            auto [ec, socket] = co_await acceptor.async_accept();
+            if (!ec)
+                co_await http_session(std::move(socket), signals);
+        },
+        net::detached);
+    std::jthread server {[&]{ ioc.run(); }};
+
+    net::io_context client_context;
+    net::ip::tcp::socket socket {client_context};
+    socket.connect(endpoint);
+    client(socket);
+}
+
+// Writes the request text and reads the response.
+http::response<http::string_body> round_trip(
+    boost::asio::ip::tcp::socket& socket,
+    std::string const& request_text)
+{
+    boost::asio::write(socket, boost::asio::buffer(request_text));
+
+    boost::beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    http::read(socket, buffer, response);
+    return response;
+}
+
+// Whether the peer closed the connection, after reading anything left.
+bool connection_closed(boost::asio::ip::tcp::socket& socket)
+{
+    boost::system::error_code ec;
+    char buffer[4096];
+    while (!ec)
+        socket.read_some(boost::asio::buffer(buffer), ec);
+    return ec == boost::asio::error::eof || ec == boost::asio::error::connection_reset;
+}
+
 BOOST_AUTO_TEST_CASE(test_http_session)
 {
     taar::session::http http_session;
@@ -93,7 +177,7 @@ BOOST_AUTO_TEST_CASE(test_http_session)
                 request.version()};
             res.set(boost::beast::http::field::content_type, "text/html");
             res.keep_alive(request.keep_alive());
-            res.body() = "Special path is: " + context.path_args.at("*path");
+            res.body() = "Special path is: " + std::string {context.path_args.at("*path")};
             res.prepare_payload();
             return res;
         }
@@ -278,4 +362,827 @@ BOOST_AUTO_TEST_CASE(test_http_session_chunked_handler)
         &async_chunked_handler);
 }
 
+BOOST_AUTO_TEST_CASE(test_http_session_route_options)
+{
+    namespace net = boost::asio;
+
+    taar::session::http http_session;
+    object_type object;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/object",
+        &object_type::fn1,
+        &object,
+        taar::session::route_options {.body_limit = 0});
+
+    // The options apply to member function routes too.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "GET /api/object HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "hello");
+        BOOST_TEST(response.result_int() == 413);
+        BOOST_TEST(connection_closed(socket));
+    });
+
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "GET /api/object HTTP/1.1\r\n"
+            "\r\n");
+        BOOST_TEST(response.result_int() == 200);
+        BOOST_TEST(response.body() == "Hello");
+    });
+}
+
+taar::awaitable<std::size_t> streaming_handler(
+    http::request<taar::streaming_body>& request,
+    taar::matcher::context const&)
+{
+    std::size_t size = 0;
+    while (true)
+    {
+        auto [ec, chunk] = co_await request.body().next();
+        if (!chunk)
+            break;
+        size += chunk->size();
+    }
+    co_return size;
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_streaming_handler)
+{
+    namespace net = boost::asio;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::post && target == "/api/upload",
+        &streaming_handler,
+        taar::session::route_options {.body_limit = 1024 * 1024 * 1024});
+
+    // Larger than a single chunk of the streaming body.
+    std::string const body(3 * taar::streaming_body::chunk_size + 7, 'x');
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "POST /api/upload HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body);
+        BOOST_TEST(response.result_int() == 200);
+        BOOST_TEST(response.body() == std::to_string(body.size()));
+    });
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_body_limit)
+{
+    namespace net = boost::asio;
+
+    std::size_t invoked = 0;
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::post && target == "/api/small",
+        [&](
+            http::request<http::string_body> const& request,
+            taar::matcher::context const&)
+        {
+            ++invoked;
+            return request.body().size();
+        },
+        taar::session::route_options {.body_limit = 1024});
+    http_session.register_request_handler(
+        method == http::verb::post && target == "/api/upload",
+        &streaming_handler,
+        taar::session::route_options {.body_limit = 1024});
+
+    std::string const large_body(2048, 'x');
+
+    // A body under the limit is read and handed to the handler.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "POST /api/small HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "hello");
+        BOOST_TEST(response.result_int() == 200);
+        BOOST_TEST(response.body() == "5");
+    });
+    BOOST_TEST(invoked == 1u);
+
+    // A declared length over the limit is rejected before the body is sent.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "POST /api/small HTTP/1.1\r\n"
+            "Content-Length: 2048\r\n"
+            "\r\n");
+        BOOST_TEST(response.result_int() == 413);
+        BOOST_TEST(connection_closed(socket));
+    });
+    BOOST_TEST(invoked == 1u);
+
+    // A chunked body is rejected once it crosses the limit.
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "POST /api/small HTTP/1.1\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "800\r\n" + large_body + "\r\n"
+            "0\r\n\r\n");
+        BOOST_TEST(response.result_int() == 413);
+        BOOST_TEST(connection_closed(socket));
+    });
+    BOOST_TEST(invoked == 1u);
+
+    // So is a streamed body, even though the handler has seen a part of it.
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "POST /api/upload HTTP/1.1\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "800\r\n" + large_body + "\r\n"
+            "0\r\n\r\n");
+        BOOST_TEST(response.result_int() == 413);
+        BOOST_TEST(connection_closed(socket));
+    });
+}
+
+std::string read_streaming_body(std::string const& request_text)
+{
+    namespace net = boost::asio;
+
+    net::io_context ioc;
+    boost::beast::test::stream stream {ioc};
+    stream.append(request_text);
+    stream.close_remote();
+
+    std::string body;
+    std::size_t chunk_count = 0;
+    net::co_spawn(ioc,
+        [&]() -> taar::awaitable<void>
+        {
+            boost::beast::flat_buffer buffer;
+            http::request_parser<http::buffer_body> parser;
+            auto [ec, sz] = co_await http::async_read_header(
+                stream,
+                buffer,
+                parser,
+                net::as_tuple(net::deferred));
+            BOOST_TEST(!ec);
+
+            auto chunks = taar::session::detail::read_body_chunks(stream, buffer, parser);
+            while (true)
+            {
+                auto [chunk_ec, chunk] = co_await chunks.next();
+                if (!chunk)
+                    break;
+                BOOST_TEST(chunk->size() <= taar::streaming_body::chunk_size);
+                body.append(reinterpret_cast<char const*>(chunk->data()), chunk->size());
+                ++chunk_count;
+            }
+
+            BOOST_TEST(parser.is_done());
+        },
+        [](std::exception_ptr ep)
+        {
+            if (ep) std::rethrow_exception(ep);
+        });
+
+    ioc.run();
+    BOOST_TEST(chunk_count != 0u);
+    return body;
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_read_body_chunks)
+{
+    BOOST_TEST(read_streaming_body(
+        "POST /api/upload HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nhello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n\r\n") == "hello world");
+
+    std::string const large_body(taar::streaming_body::chunk_size * 2 + 10, 'x');
+    BOOST_TEST(read_streaming_body(
+        "POST /api/upload HTTP/1.1\r\n"
+        "Content-Length: " + std::to_string(large_body.size()) + "\r\n"
+        "\r\n" + large_body) == large_body);
+}
+
+struct discard_result
+{
+    bool drained = false;
+    std::string remaining;
+};
+
+discard_result discard_request_body(std::string const& request_text, std::uint64_t limit)
+{
+    namespace net = boost::asio;
+
+    net::io_context ioc;
+    boost::beast::test::stream stream {ioc};
+    stream.append(request_text);
+    stream.close_remote();
+
+    discard_result result;
+    net::co_spawn(ioc,
+        [&]() -> taar::awaitable<void>
+        {
+            boost::beast::flat_buffer buffer;
+            http::request_parser<http::buffer_body> parser;
+            auto [ec, sz] = co_await http::async_read_header(
+                stream,
+                buffer,
+                parser,
+                net::as_tuple(net::deferred));
+            BOOST_TEST(!ec);
+
+            result.drained = co_await taar::session::detail::discard_body(
+                stream,
+                buffer,
+                parser,
+                limit);
+            result.remaining = boost::beast::buffers_to_string(buffer.data()) + stream.str();
+        },
+        [](std::exception_ptr ep)
+        {
+            if (ep) std::rethrow_exception(ep);
+        });
+
+    ioc.run();
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_discard_body)
+{
+    std::string const next_request = "GET / HTTP/1.1\r\n\r\n";
+    std::string const body(10000, 'x');
+
+    auto const drained = discard_request_body(
+        "POST /unknown HTTP/1.1\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body + next_request,
+        64 * 1024);
+    BOOST_TEST(drained.drained);
+    BOOST_TEST(drained.remaining == next_request);
+
+    auto const chunked = discard_request_body(
+        "POST /unknown HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nhello\r\n"
+        "0\r\n\r\n" + next_request,
+        64 * 1024);
+    BOOST_TEST(chunked.drained);
+    BOOST_TEST(chunked.remaining == next_request);
+
+    auto const no_body = discard_request_body(next_request + next_request, 0);
+    BOOST_TEST(no_body.drained);
+    BOOST_TEST(no_body.remaining == next_request);
+
+    // Too large bodies are not drained.
+    auto const too_large = discard_request_body(
+        "POST /unknown HTTP/1.1\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body,
+        1024);
+    BOOST_TEST(!too_large.drained);
+
+    auto const too_large_chunked = discard_request_body(
+        "POST /unknown HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "2710\r\n" + body + "\r\n"
+        "0\r\n\r\n",
+        1024);
+    BOOST_TEST(!too_large_chunked.drained);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_admission_expect_continue)
+{
+    namespace net = boost::asio;
+
+    std::size_t invoked = 0;
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::put && target == "/api/upload",
+        [&](
+            http::request<http::string_body> const& request,
+            taar::matcher::context const&)
+        {
+            ++invoked;
+            return request.body().size();
+        },
+        taar::session::route_options {
+            .admission = [](
+                http::request_header<> const& request,
+                taar::matcher::context const&) -> std::optional<http::status>
+            {
+                if (request.count(http::field::authorization) == 0)
+                    return http::status::unauthorized;
+                return std::nullopt;
+            }});
+
+    // A rejected request gets the final status right away, and the client
+    // never sends the body.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "PUT /api/upload HTTP/1.1\r\n"
+            "Expect: 100-continue\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n");
+        BOOST_TEST(response.result_int() == 401);
+        BOOST_TEST(connection_closed(socket));
+    });
+    BOOST_TEST(invoked == 0u);
+
+    // So does a request without the expectation. The body is left unsent so
+    // the rejection doesn't race with unread data.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const response = round_trip(socket,
+            "PUT /api/upload HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n");
+        BOOST_TEST(response.result_int() == 401);
+        BOOST_TEST(connection_closed(socket));
+    });
+    BOOST_TEST(invoked == 0u);
+
+    // An admitted request gets a 100 Continue, then the body is sent and the
+    // handler responds.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        auto const interim = round_trip(socket,
+            "PUT /api/upload HTTP/1.1\r\n"
+            "Authorization: Bearer token\r\n"
+            "Expect: 100-continue\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n");
+        BOOST_TEST(interim.result_int() == 100);
+
+        auto const response = round_trip(socket, "hello");
+        BOOST_TEST(response.result_int() == 200);
+        BOOST_TEST(response.body() == "5");
+    });
+    BOOST_TEST(invoked == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_expect_continue)
+{
+    namespace net = boost::asio;
+    using taar::session::detail::expects_continue;
+
+    http::request_header<> header;
+    BOOST_TEST(!expects_continue(header));
+    header.set(http::field::expect, "100-Continue");
+    BOOST_TEST(expects_continue(header));
+    header.set(http::field::expect, "something-else");
+    BOOST_TEST(!expects_continue(header));
+
+    net::io_context ioc;
+    boost::beast::test::stream local {ioc};
+    boost::beast::test::stream remote {ioc};
+    local.connect(remote);
+
+    bool written = false;
+    net::co_spawn(ioc,
+        [&]() -> taar::awaitable<void>
+        {
+            written = co_await taar::session::detail::write_continue(local, 11);
+        },
+        [](std::exception_ptr ep)
+        {
+            if (ep) std::rethrow_exception(ep);
+        });
+
+    ioc.run();
+    BOOST_TEST(written);
+    BOOST_TEST(remote.str() == "HTTP/1.1 100 Continue\r\n\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_timeouts)
+{
+    using namespace std::chrono_literals;
+    taar::session::http http_session;
+
+    BOOST_TEST((http_session.timeouts().keep_alive > 0s));
+    BOOST_TEST((http_session.timeouts().header_read > 0s));
+    BOOST_TEST((http_session.timeouts().body_read > 0s));
+    BOOST_TEST((http_session.timeouts().write > 0s));
+
+    http_session.set_timeouts({
+        .keep_alive = 5s,
+        .header_read = 10s,
+        .body_read = 0s,
+        .write = 20s});
+    BOOST_TEST((http_session.timeouts().keep_alive == 5s));
+    BOOST_TEST((http_session.timeouts().header_read == 10s));
+    BOOST_TEST((http_session.timeouts().body_read == 0s));
+    BOOST_TEST((http_session.timeouts().write == 20s));
+
+    BOOST_TEST(http_session.metrics().keep_alive_timeouts.load() == 0u);
+    BOOST_TEST(http_session.metrics().header_read_timeouts.load() == 0u);
+    BOOST_TEST(http_session.metrics().body_read_timeouts.load() == 0u);
+    BOOST_TEST(http_session.metrics().write_timeouts.load() == 0u);
+}
+
+// Checks that each timeout fires on an io_context with the concurrency hint.
+void check_timeouts_expire(int concurrency_hint)
+{
+    namespace net = boost::asio;
+    using namespace std::chrono_literals;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::post && target == "/api/upload",
+        [](
+            http::request<http::string_body> const& request,
+            taar::matcher::context const&)
+        {
+            return request.body().size();
+        });
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/large",
+        [](
+            http::request<http::empty_body> const&,
+            taar::matcher::context const&)
+        {
+            // More than the socket buffers can hold.
+            return std::string(64 * 1024 * 1024, 'x');
+        });
+    http_session.set_timeouts({
+        .keep_alive = 50ms,
+        .header_read = 50ms,
+        .body_read = 50ms,
+        .write = 50ms});
+
+    // Nothing is sent on the connection.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        BOOST_TEST(connection_closed(socket));
+    }, concurrency_hint);
+    BOOST_TEST(http_session.metrics().keep_alive_timeouts.load() == 1u);
+
+    // The header is never completed.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        net::write(socket, net::buffer(std::string {
+            "POST /api/upload HTTP/1.1\r\n"}));
+        BOOST_TEST(connection_closed(socket));
+    }, concurrency_hint);
+    BOOST_TEST(http_session.metrics().header_read_timeouts.load() == 1u);
+    BOOST_TEST(http_session.metrics().body_read_timeouts.load() == 0u);
+
+    // The body is never completed.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        net::write(socket, net::buffer(std::string {
+            "POST /api/upload HTTP/1.1\r\n"
+            "Content-Length: 10\r\n"
+            "\r\n"
+            "abc"}));
+        BOOST_TEST(connection_closed(socket));
+    }, concurrency_hint);
+    BOOST_TEST(http_session.metrics().header_read_timeouts.load() == 1u);
+    BOOST_TEST(http_session.metrics().body_read_timeouts.load() == 1u);
+
+    // The response is never read.
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        socket.set_option(net::socket_base::receive_buffer_size(4096));
+        net::write(socket, net::buffer(std::string {
+            "GET /api/large HTTP/1.1\r\n"
+            "\r\n"}));
+        std::this_thread::sleep_for(500ms);
+        BOOST_TEST(connection_closed(socket));
+    }, concurrency_hint);
+    BOOST_TEST(http_session.metrics().write_timeouts.load() == 1u);
+    BOOST_TEST(http_session.metrics().keep_alive_timeouts.load() == 1u);
+    BOOST_TEST(http_session.metrics().header_read_timeouts.load() == 1u);
+    BOOST_TEST(http_session.metrics().body_read_timeouts.load() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_timeouts_expire)
+{
+    // The timer wheel of a single threaded io_context.
+    check_timeouts_expire(1);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_timeouts_expire_default_context)
+{
+    // The timers of tcp_stream.
+    check_timeouts_expire(BOOST_ASIO_CONCURRENCY_HINT_DEFAULT);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_pipelined_requests)
+{
+    namespace net = boost::asio;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::post && target == "/echo/{name}",
+        [](
+            http::request<http::string_body> const& request,
+            taar::matcher::context const& context)
+        {
+            return
+                std::string {context.path_args.at("name")} + ":" +
+                request.body() + ":" +
+                std::to_string(request.count("X-First"));
+        });
+
+    serve_connection(http_session, [](net::ip::tcp::socket& socket)
+    {
+        // Both requests arrive in a single read, so the second one is parsed
+        // from the bytes left in the connection buffer after the first one.
+        net::write(socket, net::buffer(std::string {
+            "POST /echo/first HTTP/1.1\r\n"
+            "X-First: 1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "hello"
+            "POST /echo/second HTTP/1.1\r\n"
+            "Content-Length: 3\r\n"
+            "\r\n"
+            "abc"}));
+
+        // Nothing of the first request leaks into the second one.
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> first;
+        http::read(socket, buffer, first);
+        BOOST_TEST(first.result_int() == 200);
+        BOOST_TEST(first.body() == "first:hello:1");
+
+        http::response<http::string_body> second;
+        http::read(socket, buffer, second);
+        BOOST_TEST(second.result_int() == 200);
+        BOOST_TEST(second.body() == "second:abc:0");
+        BOOST_TEST(buffer.size() == 0u);
+    });
+}
+
+// Largest increase of the allocations between two warm requests.
+template <std::size_t Size>
+std::size_t most_per_request(
+    std::array<std::size_t, Size> const& allocations,
+    std::size_t warm_up_count)
+{
+    std::size_t most = 0;
+    for (auto request = warm_up_count; request + 1 != Size; ++request)
+    {
+        most = std::max(most, allocations[request + 1] - allocations[request]);
+    }
+    return most;
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_warm_allocations)
+{
+    namespace net = boost::asio;
+    constexpr std::size_t request_count = 64;
+    constexpr std::size_t warm_up_count = 16;
+
+    // Allocations of the server thread until each invocation of the handler.
+    std::array<std::size_t, request_count> allocations {};
+    std::size_t invocations = 0;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/ping",
+        [&](
+            http::request<http::empty_body> const& request,
+            taar::matcher::context const&)
+        {
+            allocations[invocations++] = heap_allocations;
+            http::response<http::empty_body> response {
+                http::status::no_content,
+                request.version()};
+            response.keep_alive(request.keep_alive());
+            return response;
+        });
+
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        boost::beast::flat_buffer buffer;
+        for (std::size_t request = 0; request != request_count; ++request)
+        {
+            net::write(socket, net::buffer(std::string_view {
+                "GET /api/ping HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "X-Request: 1\r\n"
+                "\r\n"}));
+
+            http::response<http::empty_body> response;
+            http::read(socket, buffer, response);
+            BOOST_TEST(response.result_int() == 204);
+        }
+    });
+    BOOST_TEST(invocations == request_count);
+
+    // Once the connection is warm, a request only allocates the fields of its
+    // header, i.e. the method and target and one node per field, and the
+    // serializer of the response. The buffer, the parser, the route candidates
+    // and the coroutine frames are reused.
+    auto const most = most_per_request(allocations, warm_up_count);
+    BOOST_TEST_MESSAGE("Heap allocations per warm request: " << most);
+    BOOST_TEST(most <= 6u);
+}
+
+BOOST_AUTO_TEST_CASE(test_http_session_warm_frames)
+{
+    namespace net = boost::asio;
+    using taar::frame_allocator;
+    constexpr std::size_t request_count = 32;
+    constexpr std::size_t warm_up_count = 8;
+
+    // Allocations of the server thread until each invocation of the handlers.
+    std::array<std::size_t, request_count> direct {};
+    std::array<std::size_t, request_count> rest {};
+    std::array<frame_allocator::statistics, request_count> frames {};
+    std::size_t direct_count = 0;
+    std::size_t rest_count = 0;
+    std::size_t chunked_count = 0;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/direct",
+        [&](
+            http::request<http::empty_body> const& request,
+            taar::matcher::context const&)
+        {
+            direct[direct_count++] = heap_allocations;
+            http::response<http::empty_body> response {
+                http::status::no_content,
+                request.version()};
+            response.keep_alive(request.keep_alive());
+            return response;
+        });
+
+    // The same response through the nested awaitables of a rest handler.
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/rest",
+        taar::handler::rest([&]
+        {
+            rest[rest_count++] = heap_allocations;
+            return http::response<http::empty_body> {
+                http::status::no_content,
+                11};
+        }));
+
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/chunked",
+        [&](
+            http::request<http::empty_body> const&,
+            taar::matcher::context const&) -> taar::chunked_response<std::string>
+        {
+            frames[chunked_count++] = frame_allocator::thread_statistics();
+            co_yield std::string {"chunk"};
+        });
+
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        for (std::string_view const route : {"/api/direct", "/api/rest", "/api/chunked"})
+        {
+            for (std::size_t request = 0; request != request_count; ++request)
+            {
+                auto const response = round_trip(socket,
+                    "GET " + std::string {route} + " HTTP/1.1\r\n"
+                    "Host: localhost\r\n"
+                    "\r\n");
+                BOOST_TEST(response.result_int() < 300);
+            }
+        }
+    });
+    BOOST_TEST(direct_count == request_count);
+    BOOST_TEST(rest_count == request_count);
+    BOOST_TEST(chunked_count == request_count);
+
+    // Once the frame caches are warm, the awaitables of the rest handler don't
+    // allocate more than the plain handler.
+    auto const direct_most = most_per_request(direct, warm_up_count);
+    auto const rest_most = most_per_request(rest, warm_up_count);
+    BOOST_TEST_MESSAGE(
+        "Heap allocations per warm request: " << direct_most <<
+        " direct, " << rest_most << " rest");
+    BOOST_TEST(rest_most <= direct_most);
+
+    // The frames of the chunked responses are recycled.
+    for (auto request = warm_up_count; request + 1 != request_count; ++request)
+    {
+        auto const& before = frames[request];
+        auto const& after = frames[request + 1];
+        BOOST_TEST(after.allocations - before.allocations >= 1u);
+        BOOST_TEST(after.allocations - before.allocations == after.recycled - before.recycled);
+    }
+}
+
+// Memory resource which counts its allocations. The memory comes from the
+// aligned operator new, which isn't counted in heap_allocations.
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return ::operator new(bytes, std::align_val_t {alignment});
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+    {
+        ::operator delete(pointer, bytes, std::align_val_t {alignment});
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_http_session_request_memory)
+{
+    namespace net = boost::asio;
+    constexpr std::size_t request_count = 4;
+
+    // The memory of the connection comes from the default resource.
+    counting_resource upstream;
+    auto* const default_resource = std::pmr::set_default_resource(&upstream);
+
+    // Heap allocations of the server thread while the handler decodes the
+    // path args and the cookies.
+    std::size_t most = 0;
+    std::size_t invocations = 0;
+    bool request_scoped = true;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/args/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}",
+        [&](
+            http::request<http::empty_body> const& request,
+            taar::matcher::context const& context)
+        {
+            ++invocations;
+            auto const before = heap_allocations;
+
+            // More path args and cookies than fit in place, each one decoded.
+            std::size_t size = 0;
+            for (auto const& arg : context.path_args)
+            {
+                size += context.path_args.value(arg).size();
+            }
+
+            auto const& cookies = context.cache.parsed_cookies(
+                request,
+                context.memory_resource);
+            for (auto const& cookie : cookies)
+            {
+                size += cookies.value(cookie).size();
+            }
+
+            most = std::max(most, heap_allocations - before);
+            request_scoped = request_scoped &&
+                context.path_args.size() > taar::matcher::flat_path_args::inline_capacity &&
+                cookies.size() > taar::cookies_view::inline_capacity &&
+                context.path_args.get_allocator().resource() == context.memory_resource &&
+                cookies.get_allocator().resource() == context.memory_resource;
+            return size;
+        });
+
+    std::string request_text = "GET /args";
+    for (int index = 0; index != 8; ++index)
+    {
+        request_text += "/x%41";
+    }
+    // Long enough not to fit in the small string buffer once decoded.
+    request_text += "/" + std::string(24, 'x') + "%41 HTTP/1.1\r\nCookie: ";
+    for (int index = 0; index != 20; ++index)
+    {
+        request_text += (index ? "; c" : "c") + std::to_string(index) + "=x%41";
+    }
+    request_text += "\r\n\r\n";
+
+    serve_connection(http_session, [&](net::ip::tcp::socket& socket)
+    {
+        for (std::size_t request = 0; request != request_count; ++request)
+        {
+            auto const response = round_trip(socket, request_text);
+            BOOST_TEST(response.result_int() == 200);
+            BOOST_TEST(response.body() == std::to_string(8 * 2 + 25 + 20 * 2));
+        }
+    });
+    std::pmr::set_default_resource(default_resource);
+
+    BOOST_TEST(invocations == request_count);
+    BOOST_TEST(request_scoped);
+    BOOST_TEST(most == 0u);
+    BOOST_TEST(upstream.allocations != 0u);
+}
+
 } // namespace
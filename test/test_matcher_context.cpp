@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/matcher/context.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(test_matcher_flat_path_args)
+{
+    using boost::taar::matcher::flat_path_args;
+
+    flat_path_args args;
+    BOOST_TEST(args.empty());
+    BOOST_TEST(args.size() == 0);
+    BOOST_TEST(!args.contains("a"));
+    BOOST_REQUIRE_THROW(args.at("a"), std::out_of_range);
+
+    std::string const target = "/first/second";
+    BOOST_TEST(args.emplace("a", std::string_view {target}.substr(1, 5)));
+    BOOST_TEST(args.emplace_owned("b", "decoded"));
+    BOOST_TEST(!args.emplace("a", "other"));
+    BOOST_TEST(args.size() == 2);
+    BOOST_TEST(args.at("a") == "first");
+    BOOST_TEST(args.at("a").data() == target.data() + 1);
+    BOOST_TEST(args.at("b") == "decoded");
+
+    args.clear();
+    BOOST_TEST(args.empty());
+    BOOST_TEST(!args.contains("a"));
+
+    // Encoded values are decoded on demand and the encoded form is kept.
+    std::string const encoded = "/first%2Fsecond/third";
+    BOOST_TEST(args.emplace_encoded("a", std::string_view {encoded}.substr(1)));
+    BOOST_TEST(args.emplace_encoded("b", std::string_view {encoded}.substr(16)));
+    BOOST_TEST(args.encoded("a") == "first%2Fsecond/third");
+    BOOST_TEST(args.at("a") == "first/second/third");
+    BOOST_TEST(args.at("a").data() == args.at("a").data());
+    BOOST_TEST(args.at("b") == "third");
+    BOOST_TEST(args.at("b").data() == encoded.data() + 16);
+    BOOST_REQUIRE_THROW(args.encoded("c"), std::out_of_range);
+
+    args = {{"a", "13"}, {"b", "42"}};
+    BOOST_TEST(args.size() == 2);
+    BOOST_TEST(args.at("a") == "13");
+    BOOST_TEST(args.at("b") == "42");
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_flat_path_args_overflow)
+{
+    using boost::taar::matcher::flat_path_args;
+
+    flat_path_args args;
+    auto const count = flat_path_args::inline_capacity * 2;
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        BOOST_TEST(args.emplace_owned(std::to_string(i), std::to_string(i * 2)));
+    }
+
+    BOOST_TEST(args.size() == count);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        BOOST_TEST(args.at(std::to_string(i)) == std::to_string(i * 2));
+    }
+
+    // Copies refer to their own storage.
+    flat_path_args copy {args};
+    args.clear();
+    BOOST_TEST(copy.size() == count);
+    BOOST_TEST(copy.at("0") == "0");
+    BOOST_TEST(copy.at(std::to_string(count - 1)) == std::to_string((count - 1) * 2));
+
+    flat_path_args moved {std::move(copy)};
+    BOOST_TEST(moved.size() == count);
+    BOOST_TEST(moved.at("3") == "6");
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_request_cache)
+{
+    namespace http = boost::beast::http;
+    using boost::taar::matcher::request_cache;
+
+    http::request_header<> req;
+    req.method(http::verb::get);
+    req.target("/a/b?c=d");
+    req.insert(http::field::cookie, "name1=value1; name2=value2");
+    req.insert(http::field::cookie, "name3=value3");
+
+    request_cache cache;
+    auto const& parsed_target = cache.parsed_target(req);
+    BOOST_TEST(parsed_target.path() == "/a/b");
+    BOOST_TEST(&cache.parsed_target(req) == &parsed_target);
+
+    auto const& parsed_cookies = cache.parsed_cookies(req);
+    BOOST_TEST(parsed_cookies.size() == 3);
+    BOOST_TEST(parsed_cookies.value(*parsed_cookies.find("name3")) == "value3");
+    BOOST_TEST(&cache.parsed_cookies(req) == &parsed_cookies);
+
+    // A different target is parsed again.
+    http::request_header<> other;
+    other.target("/x");
+    BOOST_TEST(cache.parsed_target(other).path() == "/x");
+
+    // The specified values are used while the scoped values are alive.
+    boost::urls::url_view const given_target {"/given"};
+    boost::taar::cookies const given_jar {{"given", "1"}};
+    boost::taar::cookies_view const given_cookies {given_jar};
+    {
+        auto const values = cache.use(given_target, given_cookies);
+        BOOST_TEST(&cache.parsed_target(req) == &given_target);
+        BOOST_TEST(&cache.parsed_cookies(req) == &given_cookies);
+    }
+    BOOST_TEST(cache.parsed_cookies(req).size() == 3);
+
+    // Copies refer to their own storage.
+    request_cache copy {cache};
+    cache.clear();
+    auto const& copied_cookies = copy.parsed_cookies(req);
+    BOOST_TEST(copied_cookies.value(*copied_cookies.find("name1")) == "value1");
+    BOOST_TEST(cache.parsed_cookies(http::request_header<> {}).empty());
+}
+
+} // namespace
@@ -9,6 +9,7 @@
 
 #include "boost/taar/core/cookies.hpp"
 #include <boost/taar/matcher/cookie.hpp>
+#include <boost/taar/matcher/method.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/version.hpp>
@@ -34,4 +35,37 @@ BOOST_AUTO_TEST_CASE(test_matcher_cookie)
     BOOST_TEST((!exist(cookie("not_exists")))(req, ctx, {}, parsed_cookies));
 }
 
+BOOST_AUTO_TEST_CASE(test_matcher_cookie_lazy)
+{
+    namespace http = boost::beast::http;
+    namespace taar = boost::taar;
+    using namespace taar::matcher;
+
+    http::request_header<> req;
+    req.method(http::verb::post);
+    req.target("/a/b");
+    req.insert(http::field::cookie, "name1=value1");
+    req.insert(http::field::cookie, "name2=value2");
+
+    // The cookies are parsed from the request on demand.
+    context ctx;
+    BOOST_TEST((cookie("name1") == "value1")(req, ctx));
+    BOOST_TEST((cookie("name2") == "value2" && method == http::verb::post)(req, ctx));
+    BOOST_TEST((cookie("name2") != "value1")(req, ctx));
+
+    // The cookies are not needed if the other operand decides the result.
+    int evaluated = 0;
+    auto counting = [&](http::request_header<> const&, context&, taar::cookies const&)
+    {
+        ++evaluated;
+        return true;
+    };
+
+    BOOST_TEST(!(method == http::verb::get && counting)(req, ctx));
+    BOOST_TEST((method == http::verb::post || counting)(req, ctx));
+    BOOST_TEST(evaluated == 0);
+    BOOST_TEST((method == http::verb::post && counting)(req, ctx));
+    BOOST_TEST(evaluated == 1);
+}
+
 } // namespace
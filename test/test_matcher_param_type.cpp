@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/matcher/param_type.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <variant>
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(test_matcher_param_type)
+{
+    using namespace boost::taar::matcher;
+
+    static_assert(detail::param_type_from_name("u64") == template_param_type::u64);
+    static_assert(detail::param_type_from_name("i64") == template_param_type::i64);
+    static_assert(detail::param_type_from_name("uuid") == template_param_type::uuid);
+    static_assert(!detail::param_type_from_name("string"));
+    static_assert(!detail::param_type_from_name("U64"));
+
+    BOOST_TEST(std::holds_alternative<std::monostate>(
+        parse_param(template_param_type::string, "anything").value()));
+
+    BOOST_TEST(std::get<std::uint64_t>(
+        parse_param(template_param_type::u64, "18446744073709551615").value()) ==
+        18446744073709551615u);
+    BOOST_TEST(!parse_param(template_param_type::u64, "18446744073709551616"));
+    BOOST_TEST(!parse_param(template_param_type::u64, "-1"));
+    BOOST_TEST(!parse_param(template_param_type::u64, "12a"));
+    BOOST_TEST(!parse_param(template_param_type::u64, ""));
+
+    BOOST_TEST(std::get<std::int64_t>(
+        parse_param(template_param_type::i64, "-42").value()) == -42);
+    BOOST_TEST(!parse_param(template_param_type::i64, "+42"));
+    BOOST_TEST(!parse_param(template_param_type::i64, "4.2"));
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_param_type_uuid)
+{
+    using namespace boost::taar::matcher;
+
+    auto const uuid = parse_uuid("123e4567-E89B-12d3-a456-426614174000");
+    BOOST_TEST(uuid.has_value());
+    BOOST_TEST(uuid->data[0] == 0x12);
+    BOOST_TEST(uuid->data[4] == 0xe8);
+    BOOST_TEST(uuid->data[15] == 0x00);
+
+    BOOST_TEST(!parse_uuid(""));
+    BOOST_TEST(!parse_uuid("123e4567e89b12d3a456426614174000"));
+    BOOST_TEST(!parse_uuid("123e4567-e89b-12d3-a456-42661417400g"));
+    BOOST_TEST(!parse_uuid("123e4567+e89b-12d3-a456-426614174000"));
+
+    BOOST_TEST(std::get<boost::uuids::uuid>(
+        parse_param(template_param_type::uuid, "123e4567-e89b-12d3-a456-426614174000").value()) ==
+        *uuid);
+}
+
+} // namespace
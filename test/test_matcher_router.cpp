@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/matcher/router.hpp>
+#include <boost/taar/matcher/method.hpp>
+#include <boost/taar/matcher/target.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/url/parse.hpp>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+namespace {
+
+using boost::taar::matcher::route_hint;
+using boost::taar::matcher::router;
+
+route_hint hint_of(std::string_view target_template)
+{
+    return (boost::taar::matcher::target == target_template).hint();
+}
+
+std::vector<router::route_type> lookup(
+    router const& r,
+    std::string_view target,
+    boost::beast::http::verb method = boost::beast::http::verb::get)
+{
+    auto const parsed = boost::urls::parse_uri_reference(target);
+    router::route_list routes;
+    r.lookup(method, parsed ? &*parsed : nullptr, routes);
+    return {routes.begin(), routes.end()};
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_route_hint)
+{
+    namespace http = boost::beast::http;
+    using namespace boost::taar::matcher;
+
+    BOOST_TEST(!(method == http::verb::get).hint().target);
+    BOOST_TEST((target == "/a/{b}").hint().target.has_value());
+    BOOST_TEST((target == "/a/{b}").hint().target->size() == 2);
+    BOOST_TEST((method == http::verb::get && target == "/a").hint().target.has_value());
+    BOOST_TEST((target == "/a" && method == http::verb::get).hint().target.has_value());
+    BOOST_TEST(!(method == http::verb::get || target == "/a").hint().target);
+    BOOST_TEST(!(target != "/a").hint().target);
+
+    BOOST_TEST(!(target == "/a").hint().method);
+    BOOST_TEST((method == http::verb::get).hint().method.value() == http::verb::get);
+    BOOST_TEST((method == "POST").hint().method.value() == http::verb::post);
+    BOOST_TEST(!(method == "CUSTOM").hint().method);
+    BOOST_TEST((target == "/a" && method == http::verb::put).hint().method.value() == http::verb::put);
+    BOOST_TEST(!(method == http::verb::get || method == http::verb::put).hint().method);
+    BOOST_TEST(!(method != http::verb::get).hint().method);
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_router)
+{
+    using routes = std::vector<router::route_type>;
+
+    router r;
+    BOOST_TEST(r.empty());
+    BOOST_TEST(lookup(r, "/a") == routes{});
+
+    r.insert(hint_of("/api/version"), 0);
+    r.insert(hint_of("/api/sum/{a}/{b}"), 1);
+    r.insert(route_hint{}, 2);
+    r.insert(hint_of("/api/{name}"), 3);
+    r.insert(hint_of("/"), 4);
+    r.insert(hint_of("/static/{*path}"), 5);
+    r.insert(hint_of("/api/version"), 6);
+    BOOST_TEST(!r.empty());
+
+    BOOST_TEST(lookup(r, "/api/version") == (routes{0, 2, 3, 6}));
+    BOOST_TEST(lookup(r, "/api/sum/1/2") == (routes{1, 2}));
+    BOOST_TEST(lookup(r, "/api/sum/1") == (routes{2}));
+    BOOST_TEST(lookup(r, "/api/other?a=1") == (routes{2, 3}));
+    BOOST_TEST(lookup(r, "/") == (routes{2, 4}));
+    BOOST_TEST(lookup(r, "/static") == (routes{2, 5}));
+    BOOST_TEST(lookup(r, "/static/a/b/c") == (routes{2, 5}));
+    BOOST_TEST(lookup(r, "/unknown") == (routes{2}));
+    BOOST_TEST(lookup(r, "/ap%69/version") == (routes{0, 2, 3, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_router_greedy)
+{
+    using routes = std::vector<router::route_type>;
+
+    router r;
+    r.insert(hint_of("/first/{*a}/sixth"), 0);
+    r.insert(hint_of("/{*a}/{b}/sixth"), 1);
+    r.insert(hint_of("/first/{*a}/{*b}"), 2);
+    r.insert(hint_of("/{*a}"), 3);
+
+    BOOST_TEST(lookup(r, "/first/second/third/sixth") == (routes{0, 1, 2, 3}));
+    BOOST_TEST(lookup(r, "/first/sixth") == (routes{0, 1, 2, 3}));
+    BOOST_TEST(lookup(r, "/sixth") == (routes{3}));
+    BOOST_TEST(lookup(r, "/second/sixth") == (routes{1, 3}));
+    BOOST_TEST(lookup(r, "/") == (routes{3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_router_typed_params)
+{
+    using routes = std::vector<router::route_type>;
+
+    router r;
+    r.insert(hint_of("/users/{id:u64}"), 0);
+    r.insert(hint_of("/users/{ts:i64}"), 1);
+    r.insert(hint_of("/users/{key:uuid}/items"), 2);
+    r.insert(hint_of("/users/{name}"), 3);
+
+    // Typed params are candidates for any segment and are told apart by their
+    // matchers, which convert the segment once.
+    BOOST_TEST(lookup(r, "/users/42") == (routes{0, 1, 3}));
+    BOOST_TEST(lookup(r, "/users/bob") == (routes{0, 1, 3}));
+    BOOST_TEST(lookup(r, "/users/123e4567-e89b-12d3-a456-426614174000/items") == (routes{2}));
+    BOOST_TEST(lookup(r, "/users/bob/items") == (routes{2}));
+    BOOST_TEST(lookup(r, "/users") == (routes{}));
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_router_methods)
+{
+    namespace http = boost::beast::http;
+    using routes = std::vector<router::route_type>;
+
+    auto hint_with_method = [](std::string_view target, http::verb method)
+    {
+        auto hint = hint_of(target);
+        hint.method = method;
+        return hint;
+    };
+
+    router r;
+    r.insert(hint_with_method("/api/items", http::verb::get), 0);
+    r.insert(hint_with_method("/api/items", http::verb::post), 1);
+    r.insert(hint_of("/api/items"), 2);
+    r.insert(route_hint {.method = http::verb::delete_}, 3);
+    r.insert(route_hint {}, 4);
+
+    BOOST_TEST(lookup(r, "/api/items", http::verb::get) == (routes{0, 2, 4}));
+    BOOST_TEST(lookup(r, "/api/items", http::verb::post) == (routes{1, 2, 4}));
+    BOOST_TEST(lookup(r, "/api/items", http::verb::put) == (routes{2, 4}));
+    BOOST_TEST(lookup(r, "/api/items", http::verb::delete_) == (routes{2, 3, 4}));
+    BOOST_TEST(lookup(r, "/other", http::verb::delete_) == (routes{3, 4}));
+    BOOST_TEST(lookup(r, "/other", http::verb::get) == (routes{4}));
+
+    // An invalid target only has the routes which aren't indexed by target.
+    BOOST_TEST(lookup(r, "/%zz", http::verb::delete_) == (routes{3, 4}));
+}
+
+} // namespace
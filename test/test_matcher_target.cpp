@@ -232,4 +232,88 @@ BOOST_AUTO_TEST_CASE(test_matcher_target_greedy)
         ctx.path_args.at("b") == ""));
 }
 
+BOOST_AUTO_TEST_CASE(test_matcher_target_route_template)
+{
+    namespace http = boost::beast::http;
+    using namespace boost::taar::matcher;
+    using namespace boost::taar::literals;
+
+    http::request<http::string_body> req{http::verb::get, "/first/se%63ond/third%2Ffourth", 10};
+    auto parsed_target = boost::urls::url_view(req.target());
+    context ctx;
+
+    BOOST_TEST(!(target == "/first"_route)(req, ctx, parsed_target, {}));
+    BOOST_TEST(!("/first/second/third"_route == target)(req, ctx, parsed_target, {}));
+    BOOST_TEST((target != "/first/{a}"_route)(req, ctx, parsed_target, {}));
+
+    ctx.path_args.clear();
+    BOOST_TEST((target == "/first/second/{a}"_route)(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.size() == 1);
+    BOOST_TEST((
+        ctx.path_args.contains("a") &&
+        ctx.path_args.at("a") == "third/fourth"));
+
+    ctx.path_args.clear();
+    BOOST_TEST(("/{*a}"_route == target)(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.size() == 1);
+    BOOST_TEST((
+        ctx.path_args.contains("a") &&
+        ctx.path_args.at("a") == "first/second/third/fourth"));
+
+    // Values are views into the request target unless they need decoding.
+    ctx.path_args.clear();
+    BOOST_TEST((target == "/{a}/{b}/{c}"_route)(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.at("a") == "first");
+    BOOST_TEST(ctx.path_args.at("a").data() == req.target().data() + 1);
+    BOOST_TEST(ctx.path_args.at("b") == "second");
+    BOOST_TEST(ctx.path_args.at("c") == "third/fourth");
+
+    // Greedy params refer to the encoded slice of the target.
+    ctx.path_args.clear();
+    BOOST_TEST((target == "/first/{*a}"_route)(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.encoded("a") == "se%63ond/third%2Ffourth");
+    BOOST_TEST(ctx.path_args.encoded("a").data() == req.target().data() + 7);
+    BOOST_TEST(ctx.path_args.at("a") == "second/third/fourth");
+
+    BOOST_TEST((target == "/first/{a}"_route).hint().target.has_value());
+    BOOST_TEST((target == "/first/{a}"_route).hint().target->size() == 2);
+
+    // The hint refers to the segments of the route template in place.
+    auto const route_matcher = target == "/first/{a}"_route;
+    BOOST_TEST(route_matcher.hint().target->data() == "/first/{a}"_route.segments.data());
+    BOOST_TEST(!route_matcher.hint().target_storage);
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_target_typed_params)
+{
+    namespace http = boost::beast::http;
+    using namespace boost::taar::matcher;
+
+    http::request<http::string_body> req{
+        http::verb::get,
+        "/users/42/-7/123e4567-e89b-12d3-a456-426614174000",
+        10};
+    auto parsed_target = boost::urls::url_view(req.target());
+    context ctx;
+
+    BOOST_TEST(!(target == "/users/{id:i64}/{ts:u64}/{key}")(req, ctx, parsed_target, {}));
+
+    ctx.path_args.clear();
+    BOOST_TEST(!(target == "/users/{id:u64}/{ts:i64}/{key:u64}")(req, ctx, parsed_target, {}));
+
+    ctx.path_args.clear();
+    BOOST_TEST((target == "/users/{id:u64}/{ts:i64}/{key:uuid}")(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.size() == 3);
+    BOOST_TEST(ctx.path_args.at("id") == "42");
+    BOOST_TEST(std::get<std::uint64_t>(ctx.path_args.find("id")->typed()) == 42u);
+    BOOST_TEST(std::get<std::int64_t>(ctx.path_args.find("ts")->typed()) == -7);
+    BOOST_TEST(std::get<boost::uuids::uuid>(ctx.path_args.find("key")->typed()).data[0] == 0x12);
+
+    // Typed params after a greedy param skip the segments of other types.
+    ctx.path_args.clear();
+    BOOST_TEST((target == "/{*a}/{key:uuid}")(req, ctx, parsed_target, {}));
+    BOOST_TEST(ctx.path_args.at("a") == "users/42/-7");
+    BOOST_TEST(std::holds_alternative<std::monostate>(ctx.path_args.find("a")->typed()));
+}
+
 } // namespace
@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/core/query_params.hpp>
+#include <boost/url/parse.hpp>
+#include <boost/url/ignore_case.hpp>
+#include <boost/test/unit_test.hpp>
+#include <memory_resource>
+#include <cstddef>
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(test_query_params)
+{
+    using boost::taar::query_params;
+    using boost::urls::ignore_case;
+
+    query_params empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(!empty.find("a"));
+    BOOST_TEST(empty.count("a") == 0);
+
+    auto const url = boost::urls::parse_origin_form("/p?a=1&b=%32&A=3&a=4&c");
+    BOOST_REQUIRE(url);
+
+    query_params const params {url->params()};
+    BOOST_TEST(params.size() == 4);
+
+    BOOST_TEST(params.count("a") == 2);
+    BOOST_TEST(params.find("a")->value == "1");
+    BOOST_TEST(params.count("b") == 1);
+    BOOST_TEST(params.find("b")->value == "2");
+    BOOST_TEST(params.contains("c"));
+    BOOST_TEST(params.find("c")->value == "");
+    BOOST_TEST(!params.contains("d"));
+
+    BOOST_TEST(params.count("A") == 1);
+    BOOST_TEST(params.count("A", ignore_case) == 3);
+    BOOST_TEST(params.find("A", ignore_case)->value == "1");
+    BOOST_TEST(params.find("B", ignore_case)->value == "2");
+    BOOST_TEST(!params.contains("B"));
+}
+
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_query_params_memory_resource)
+{
+    using boost::taar::query_params;
+
+    auto const url = boost::urls::parse_origin_form(
+        "/p?a_long_key_which_does_not_fit_in_sso=a_long_value_which_does_not_fit_in_sso");
+    BOOST_REQUIRE(url);
+
+    counting_resource resource;
+    query_params const params {url->params(), &resource};
+    BOOST_TEST(resource.allocations != 0u);
+    BOOST_TEST(params.find("a_long_key_which_does_not_fit_in_sso")->value ==
+        "a_long_value_which_does_not_fit_in_sso");
+    BOOST_TEST(params.find("a_long_key_which_does_not_fit_in_sso")->value.get_allocator().resource() == &resource);
+
+    // Copies don't refer to the resource of the original.
+    query_params const copy {params};
+    BOOST_TEST(copy.find("a_long_key_which_does_not_fit_in_sso")->value.get_allocator().resource() ==
+        std::pmr::get_default_resource());
+}
+
+} // namespace
@@ -88,10 +88,31 @@ BOOST_AUTO_TEST_CASE(test_rest_arg)
     BOOST_TEST((get_rest_arg<std::string, query_arg>(query_arg("a"), 0, req, ctx) == "13"));
     BOOST_TEST((get_rest_arg<std::string_view, query_arg>(query_arg("a"), 0, req, ctx) == "13"));
 
+    // The query is parsed once and shared by the query args of the request.
+    http::request<http::string_body> query_req{http::verb::get, "/?a=1&b=2&a=3&C=4", 10};
+    context query_ctx;
+    auto const& parsed_query = query_ctx.cache.parsed_query(query_req);
+    BOOST_TEST(query_arg("b")(query_req, query_ctx).value() == "2");
+    BOOST_TEST(query_arg("a")(query_req, query_ctx).error() == taar::error::argument_ambiguous);
+    BOOST_TEST(query_arg("d")(query_req, query_ctx).error() == taar::error::argument_not_found);
+    BOOST_TEST(query_arg("c", boost::urls::ignore_case)(query_req, query_ctx).value() == "4");
+    BOOST_TEST(&query_ctx.cache.parsed_query(query_req) == &parsed_query);
+
     BOOST_TEST((get_rest_arg<int, path_arg>(path_arg("a"), 0, req, ctx) == 13));
     BOOST_TEST((get_rest_arg<int, path_arg>(path_arg("b"), 0, req, ctx) == 42));
     BOOST_TEST((get_rest_arg<std::string, path_arg>(path_arg("b"), 0, req, ctx) == "42"));
 
+    // Typed path params use the value converted while matching.
+    context typed_ctx;
+    typed_ctx.path_args.emplace_encoded("id", "7", std::uint64_t {13});
+    typed_ctx.path_args.emplace_encoded("big", "4294967296", std::uint64_t {4294967296});
+    BOOST_TEST((get_rest_arg<int, path_arg>(path_arg("id"), 0, req, typed_ctx) == 13));
+    BOOST_TEST((get_rest_arg<std::string, path_arg>(path_arg("id"), 0, req, typed_ctx) == "7"));
+    BOOST_TEST((get_rest_arg<std::uint64_t, path_arg>(path_arg("big"), 0, req, typed_ctx) == 4294967296));
+    BOOST_REQUIRE_THROW(
+        (get_rest_arg<std::int32_t, path_arg>(path_arg("big"), 0, req, typed_ctx)),
+        boost::system::system_error);
+
     BOOST_TEST((get_rest_arg<std::string, header_arg>(header_arg("header1"), 0, req, ctx) == "value1"));
     BOOST_TEST((get_rest_arg<std::string_view, header_arg>(header_arg("header2"), 0, req, ctx) == "value2"));
     BOOST_TEST((get_rest_arg<std::string_view, header_arg>(header_arg("pi"), 0, req, ctx) == "3.14"));
@@ -178,19 +199,30 @@ BOOST_AUTO_TEST_CASE(test_rest_arg_cookie)
     BOOST_TEST((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie2"), 0, req, ctx) == "value2"));
     BOOST_TEST((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie3"), 0, req, ctx) == "value3"));
 
+    // The cookies are parsed once per request and shared by the cookie args.
+    auto const& parsed_cookies = ctx.cache.parsed_cookies(req);
+    BOOST_TEST(parsed_cookies.size() == 3);
+    BOOST_TEST((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie2"), 0, req, ctx) == "value2"));
+    BOOST_TEST(&ctx.cache.parsed_cookies(req) == &parsed_cookies);
+
     req.set(http::field::cookie, "cookie1=");
+    ctx.cache.clear();
     BOOST_TEST((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie1"), 0, req, ctx) == ""));
 
     req.set(http::field::cookie, "");
+    ctx.cache.clear();
     BOOST_REQUIRE_THROW((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie1"), 0, req, ctx)), boost::system::system_error);
 
     req.set(http::field::cookie, "cookie1");
+    ctx.cache.clear();
     BOOST_REQUIRE_THROW((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie1"), 0, req, ctx)), boost::system::system_error);
 
     req.set(http::field::cookie, "cookie1;");
+    ctx.cache.clear();
     BOOST_REQUIRE_THROW((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie1"), 0, req, ctx)), boost::system::system_error);
 
     req.set(http::field::cookie, ";");
+    ctx.cache.clear();
     BOOST_REQUIRE_THROW((get_rest_arg<std::string, cookie_arg>(cookie_arg("cookie1"), 0, req, ctx)), boost::system::system_error);
 }
 
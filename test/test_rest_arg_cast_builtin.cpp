@@ -10,6 +10,7 @@
 #include <boost/system/system_error.hpp>
 #include <boost/taar/handler/rest_arg_cast.hpp>
 #include <boost/json/value_from.hpp>
+#include <boost/uuid/uuid.hpp>
 #include <boost/test/unit_test.hpp>
 
 namespace {
@@ -71,6 +72,10 @@ BOOST_AUTO_TEST_CASE(test_rest_arg_cast_builtin_traits)
     static_assert(!rest_arg_castable<int, std::string_view>, "Failed!");
     static_assert(!rest_arg_castable<int, char const*>, "Failed!");
     static_assert(rest_arg_castable<std::string, std::string_view>, "Failed!");
+    static_assert(rest_arg_castable<std::string_view, std::string>, "Failed!");
+    static_assert(rest_arg_castable<std::string_view, std::string_view>, "Failed!");
+    static_assert(rest_arg_castable<std::string_view, char const*>, "Failed!");
+    static_assert(rest_arg_castable<std::string_view, boost::uuids::uuid>, "Failed!");
     static_assert(rest_arg_castable<float, int>, "Failed!");
     static_assert(rest_arg_castable<int, float>, "Failed!");
     static_assert(rest_arg_castable<double, float>, "Failed!");
@@ -89,9 +94,14 @@ BOOST_AUTO_TEST_CASE(test_rest_arg_cast_builtin)
 
     BOOST_TEST(rest_arg_cast<int>(13) == 13);
     BOOST_TEST(rest_arg_cast<int>("42") == 42);
+    BOOST_TEST(rest_arg_cast<int>(std::string_view {"42"}) == 42);
+    BOOST_TEST(rest_arg_cast<std::string>(std::string_view {"42"}) == "42");
+    BOOST_TEST(rest_arg_cast<std::string_view>(std::string_view {"42"}) == "42");
     BOOST_TEST(rest_arg_cast<float>("3.14") == 3.14f);
     BOOST_TEST(rest_arg_cast<float>("3") == 3.0f);
     BOOST_REQUIRE_THROW(rest_arg_cast<int>("not a number"), boost::system::system_error);
+    BOOST_TEST(rest_arg_cast<boost::uuids::uuid>("123e4567-e89b-12d3-a456-426614174000").data[0] == 0x12);
+    BOOST_REQUIRE_THROW(rest_arg_cast<boost::uuids::uuid>("123e4567"), boost::system::system_error);
     BOOST_REQUIRE_THROW(rest_arg_cast<int>("13.7"), boost::system::system_error);
     BOOST_TEST(rest_arg_cast<bool>("true"));
     BOOST_TEST(!rest_arg_cast<bool>("false"));
@@ -36,6 +36,7 @@ s1 tag_invoke(rest_arg_cast_tag<s1>, std::string const& from)
 BOOST_AUTO_TEST_CASE(test_rest_arg_cast_user_traits)
 {
     static_assert(rest_arg_castable<std::string, s1>, "Failed!");
+    static_assert(rest_arg_castable<std::string_view, s1>, "Failed!");
 }
 
 BOOST_AUTO_TEST_CASE(test_rest_arg_cast_user)
@@ -43,6 +44,7 @@ BOOST_AUTO_TEST_CASE(test_rest_arg_cast_user)
     using namespace boost::taar::handler::detail;
 
     BOOST_TEST((rest_arg_cast<s1>("13") == s1{ .i = 13 }));
+    BOOST_TEST((rest_arg_cast<s1>(std::string_view {"13"}) == s1{ .i = 13 }));
 }
 
 } // namespace
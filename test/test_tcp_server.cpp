@@ -9,9 +9,26 @@
 
 #include <boost/taar/session/http.hpp>
 #include <boost/taar/server/tcp.hpp>
+#include <boost/taar/server/multi_core.hpp>
+#include <boost/taar/handler/rest.hpp>
+#include <boost/taar/matcher/method.hpp>
+#include <boost/taar/matcher/target.hpp>
 #include <boost/taar/core/cancellation_signals.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/string_body.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_tcp_server)
 {
@@ -29,3 +46,340 @@ BOOST_AUTO_TEST_CASE(test_tcp_server)
         [](net::ip::tcp::endpoint const&){});
 }
 
+
+BOOST_AUTO_TEST_CASE(test_multi_core_server)
+{
+    namespace net = boost::asio;
+    namespace http = boost::beast::http;
+    namespace taar = boost::taar;
+    using taar::matcher::method;
+    using taar::matcher::target;
+
+    taar::server::multi_core server {2};
+    BOOST_TEST(server.size() == 2u);
+
+    std::promise<unsigned short> port_promise;
+    taar::cancellation_signals cancellation_signals;
+    int sessions = 0;
+    server.listen(
+        "127.0.0.1",
+        "0",
+        [&](taar::session::http& http_session)
+        {
+            ++sessions;
+            http_session.register_request_handler(
+                method == http::verb::get && target == "/api/version",
+                taar::handler::rest([]{ return "1.0"; }));
+        },
+        cancellation_signals,
+        [&](net::ip::tcp::endpoint const& endpoint)
+        {
+            port_promise.set_value(endpoint.port());
+        });
+
+    // Each core has its own session handler.
+    BOOST_TEST(sessions == 2);
+
+    std::jthread runner {[&]{ server.run(); }};
+    auto const port = port_promise.get_future().get();
+
+    // Whichever core accepts a connection serves it with the same routes.
+    net::io_context client_context;
+    for (int i = 0; i != 8; ++i)
+    {
+        net::ip::tcp::socket client {client_context};
+        client.connect({net::ip::make_address("127.0.0.1"), port});
+
+        http::request<http::empty_body> request {http::verb::get, "/api/version", 11};
+        request.keep_alive(false);
+        http::write(client, request);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client, buffer, response);
+        BOOST_TEST(response.result_int() == 200);
+    }
+
+    server.stop();
+}
+
+BOOST_AUTO_TEST_CASE(test_strand_server)
+{
+    namespace net = boost::asio;
+    namespace http = boost::beast::http;
+    namespace taar = boost::taar;
+    using taar::matcher::method;
+    using taar::matcher::target;
+    using strand_type = net::strand<net::io_context::executor_type>;
+
+    // The session, its handlers and the server all run on strands.
+    taar::session::basic_http<strand_type> http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/version",
+        taar::handler::rest<strand_type>([]{ return "1.0"; }));
+
+    net::io_context io_context;
+    std::promise<unsigned short> port_promise;
+    taar::cancellation_signals cancellation_signals;
+    net::co_spawn(
+        net::make_strand(io_context),
+        taar::server::tcp<strand_type>(
+            "127.0.0.1",
+            "0",
+            http_session,
+            cancellation_signals,
+            [&](net::ip::tcp::endpoint const& endpoint)
+            {
+                port_promise.set_value(endpoint.port());
+            }),
+        cancellation_signals.bind(net::detached));
+
+    std::jthread runner1 {[&]{ io_context.run(); }};
+    std::jthread runner2 {[&]{ io_context.run(); }};
+    auto const port = port_promise.get_future().get();
+
+    net::io_context client_context;
+    for (int i = 0; i != 4; ++i)
+    {
+        net::ip::tcp::socket client {client_context};
+        client.connect({net::ip::make_address("127.0.0.1"), port});
+
+        http::request<http::empty_body> request {http::verb::get, "/api/version", 11};
+        request.keep_alive(false);
+        http::write(client, request);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client, buffer, response);
+        BOOST_TEST(response.result_int() == 200);
+    }
+
+    io_context.stop();
+}
+
+BOOST_AUTO_TEST_CASE(test_tcp_server_accept_batch)
+{
+    namespace net = boost::asio;
+    namespace http = boost::beast::http;
+    namespace taar = boost::taar;
+    using taar::matcher::method;
+    using taar::matcher::target;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/version",
+        taar::handler::rest([]{ return "1.0"; }));
+
+    taar::server::tcp_metrics metrics;
+    net::io_context io_context;
+    std::optional<unsigned short> port;
+    taar::cancellation_signals cancellation_signals;
+    net::co_spawn(
+        io_context,
+        taar::server::tcp(
+            "127.0.0.1",
+            "0",
+            http_session,
+            cancellation_signals,
+            [&](net::ip::tcp::endpoint const& endpoint)
+            {
+                port = endpoint.port();
+            },
+            taar::server::tcp_options {
+                .accept_concurrency = 4,
+                .accept_batch = 8,
+                .metrics = &metrics}),
+        cancellation_signals.bind(net::detached));
+
+    // Run the server until it listens and its accept operations are waiting.
+    while (!port)
+    {
+        io_context.poll();
+    }
+    io_context.poll();
+
+    // Connect all the clients before the server runs again so they pile up in
+    // the backlog and are taken in batches.
+    net::io_context client_context;
+    std::vector<net::ip::tcp::socket> clients;
+    for (int i = 0; i != 16; ++i)
+    {
+        clients.emplace_back(client_context).connect(
+            {net::ip::make_address("127.0.0.1"), *port});
+    }
+
+    std::jthread runner {[&]{ io_context.run(); }};
+
+    for (auto& client : clients)
+    {
+        http::request<http::empty_body> request {http::verb::get, "/api/version", 11};
+        request.keep_alive(false);
+        http::write(client, request);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client, buffer, response);
+        BOOST_TEST(response.result_int() == 200);
+    }
+
+    BOOST_TEST(metrics.accepted.load() == 16u);
+    BOOST_TEST(metrics.wakeups.load() < metrics.accepted.load());
+    BOOST_TEST(metrics.accept_errors.load() == 0u);
+
+    io_context.stop();
+}
+
+BOOST_AUTO_TEST_CASE(test_tcp_server_connection_limit)
+{
+    namespace net = boost::asio;
+    namespace http = boost::beast::http;
+    namespace taar = boost::taar;
+    using taar::matcher::method;
+    using taar::matcher::target;
+
+    taar::session::http http_session;
+    http_session.register_request_handler(
+        method == http::verb::get && target == "/api/version",
+        taar::handler::rest([]{ return "1.0"; }));
+
+    auto const spawn_server = [&](
+        net::io_context& io_context,
+        taar::cancellation_signals& cancellation_signals,
+        std::promise<unsigned short>& port_promise,
+        taar::server::tcp_options options)
+    {
+        net::co_spawn(
+            io_context,
+            taar::server::tcp(
+                "127.0.0.1",
+                "0",
+                http_session,
+                cancellation_signals,
+                [&](net::ip::tcp::endpoint const& endpoint)
+                {
+                    port_promise.set_value(endpoint.port());
+                },
+                options),
+            cancellation_signals.bind(net::detached));
+    };
+
+    auto const get_version = [](net::ip::tcp::socket& client)
+    {
+        http::request<http::empty_body> request {http::verb::get, "/api/version", 11};
+        http::write(client, request);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client, buffer, response);
+        return response.result_int();
+    };
+
+    net::io_context client_context;
+
+    // Over the limit, the connections are closed with the overload response.
+    {
+        taar::server::tcp_metrics metrics;
+        net::io_context io_context;
+        taar::cancellation_signals cancellation_signals;
+        std::promise<unsigned short> port_promise;
+        spawn_server(io_context, cancellation_signals, port_promise, {
+            .max_connections = 1,
+            .overload_response = taar::server::http_service_unavailable,
+            .metrics = &metrics});
+        std::jthread runner {[&]{ io_context.run(); }};
+        auto const port = port_promise.get_future().get();
+
+        net::ip::tcp::socket client1 {client_context};
+        client1.connect({net::ip::make_address("127.0.0.1"), port});
+        BOOST_TEST(get_version(client1) == 200);
+
+        // The request of a rejected connection is drained, so the connection
+        // ends with the overload response rather than a reset.
+        net::ip::tcp::socket client2 {client_context};
+        client2.connect({net::ip::make_address("127.0.0.1"), port});
+        http::request<http::empty_body> request {http::verb::get, "/api/version", 11};
+        http::write(client2, request);
+        client2.shutdown(net::socket_base::shutdown_send);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client2, buffer, response);
+        BOOST_TEST(response.result_int() == 503);
+
+        boost::system::error_code ec;
+        char byte;
+        client2.read_some(net::buffer(&byte, 1), ec);
+        BOOST_TEST(ec == net::error::eof);
+
+        BOOST_TEST(metrics.live_connections.load() == 1u);
+        BOOST_TEST(metrics.rejected_connections.load() == 1u);
+        io_context.stop();
+    }
+
+    // Over the max number of draining connections, a rejected connection is
+    // closed right after the overload response.
+    {
+        taar::server::tcp_metrics metrics;
+        net::io_context io_context;
+        taar::cancellation_signals cancellation_signals;
+        std::promise<unsigned short> port_promise;
+        spawn_server(io_context, cancellation_signals, port_promise, {
+            .max_connections = 1,
+            .overload_response = taar::server::http_service_unavailable,
+            .overload_drain = std::chrono::hours {1},
+            .max_draining = 0,
+            .metrics = &metrics});
+        std::jthread runner {[&]{ io_context.run(); }};
+        auto const port = port_promise.get_future().get();
+
+        net::ip::tcp::socket client1 {client_context};
+        client1.connect({net::ip::make_address("127.0.0.1"), port});
+        BOOST_TEST(get_version(client1) == 200);
+
+        // The client doesn't close its side, so only closing without a drain
+        // ends the connection.
+        net::ip::tcp::socket client2 {client_context};
+        client2.connect({net::ip::make_address("127.0.0.1"), port});
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(client2, buffer, response);
+        BOOST_TEST(response.result_int() == 503);
+
+        boost::system::error_code ec;
+        char byte;
+        client2.read_some(net::buffer(&byte, 1), ec);
+        BOOST_TEST(ec == net::error::eof);
+
+        BOOST_TEST(metrics.rejected_connections.load() == 1u);
+        io_context.stop();
+    }
+
+    // Without an overload response, accepting resumes once a session ends.
+    {
+        taar::server::tcp_metrics metrics;
+        net::io_context io_context;
+        taar::cancellation_signals cancellation_signals;
+        std::promise<unsigned short> port_promise;
+        spawn_server(io_context, cancellation_signals, port_promise, {
+            .max_connections = 1,
+            .metrics = &metrics});
+        std::jthread runner {[&]{ io_context.run(); }};
+        auto const port = port_promise.get_future().get();
+
+        net::ip::tcp::socket client1 {client_context};
+        client1.connect({net::ip::make_address("127.0.0.1"), port});
+        BOOST_TEST(get_version(client1) == 200);
+
+        // The second connection waits in the backlog until the first one is
+        // closed.
+        net::ip::tcp::socket client2 {client_context};
+        client2.connect({net::ip::make_address("127.0.0.1"), port});
+        client1.close();
+        BOOST_TEST(get_version(client2) == 200);
+
+        BOOST_TEST(metrics.paused_accepts.load() >= 1u);
+        BOOST_TEST(metrics.rejected_connections.load() == 0u);
+        io_context.stop();
+    }
+}
@@ -36,6 +36,32 @@ inline std::ostream& operator<<(
     return os;
 }
 
+// streaming operator for template_param_type
+inline std::ostream& operator<<(
+    std::ostream& os,
+    template_param_type type)
+{
+    switch (type)
+    {
+    case boost::taar::matcher::template_param_type::string:
+        os << "string";
+        break;
+    case boost::taar::matcher::template_param_type::u64:
+        os << "u64";
+        break;
+    case boost::taar::matcher::template_param_type::i64:
+        os << "i64";
+        break;
+    case boost::taar::matcher::template_param_type::uuid:
+        os << "uuid";
+        break;
+    default:
+        os << "unknown";
+        break;
+    }
+    return os;
+}
+
 } // namespace boost::taar::matcher
 
 namespace {
@@ -207,4 +233,59 @@ BOOST_AUTO_TEST_CASE(test_matcher_template_parser)
     BOOST_TEST(result.value()[2].value == "third");
 }
 
+BOOST_AUTO_TEST_CASE(test_matcher_route_template_literal)
+{
+    using namespace boost::taar::matcher;
+    using namespace boost::taar::literals;
+
+    // Route templates are parsed at compile time.
+    constexpr auto route = "/first/{second}/{*third}"_route;
+    static_assert(route.size() == 3);
+    static_assert(route[0] == template_segment_ref {template_segment_type::literal, "first"});
+    static_assert(route[1] == template_segment_ref {template_segment_type::param, "second"});
+    static_assert(route[2] == template_segment_ref {template_segment_type::greedy_param, "third"});
+    static_assert("/"_route.size() == 0);
+    static_assert("//first//"_route.size() == 1);
+
+    auto const result = parse_template("/first/{second}/{*third}");
+    BOOST_TEST(!result.has_error());
+    BOOST_TEST(result.value().size() == route.size());
+    for (std::size_t i = 0; i != route.size(); ++i)
+    {
+        BOOST_TEST(result.value()[i].type == route[i].type);
+        BOOST_TEST(result.value()[i].value == route[i].value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_matcher_template_parser_typed_params)
+{
+    using namespace boost::taar::matcher;
+    using namespace boost::taar::literals;
+
+    auto result = parse_template("/users/{id:u64}/{ts:i64}/{key:uuid}/{name}");
+    BOOST_TEST(!result.has_error());
+    BOOST_TEST(result.value().size() == 5);
+    BOOST_TEST(result.value()[0].param_type == template_param_type::string);
+    BOOST_TEST(result.value()[1].type == template_segment_type::param);
+    BOOST_TEST(result.value()[1].value == "id");
+    BOOST_TEST(result.value()[1].param_type == template_param_type::u64);
+    BOOST_TEST(result.value()[2].value == "ts");
+    BOOST_TEST(result.value()[2].param_type == template_param_type::i64);
+    BOOST_TEST(result.value()[3].value == "key");
+    BOOST_TEST(result.value()[3].param_type == template_param_type::uuid);
+    BOOST_TEST(result.value()[4].param_type == template_param_type::string);
+
+    BOOST_TEST(parse_template("/{id:}").has_error());
+    BOOST_TEST(parse_template("/{id:u32}").has_error());
+    BOOST_TEST(parse_template("/{id:u64").has_error());
+    BOOST_TEST(parse_template("/{id:u-64}").has_error());
+    BOOST_TEST(parse_template("/{*rest:u64}").has_error());
+
+    constexpr auto route = "/users/{id:u64}"_route;
+    static_assert(route[1] == template_segment_ref {
+        template_segment_type::param,
+        "id",
+        template_param_type::u64});
+}
+
 } // namespace
@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2022-2024 Reza Jahanbakhshi (reza dot jahanbakhshi at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/rjahanbakhshi/boost-taar
+//
+
+#include <boost/taar/core/timer_wheel.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+
+namespace {
+
+using boost::taar::timer_wheel;
+using boost::taar::timer_wheel_service;
+using boost::taar::find_timer_wheel;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel)
+{
+    boost::asio::io_context ioc;
+    timer_wheel wheel {ioc.get_executor(), 1ms};
+
+    int expired1 = 0;
+    int expired2 = 0;
+    int expired3 = 0;
+    timer_wheel::entry entry1 {[&]{ ++expired1; }};
+    timer_wheel::entry entry2 {[&]{ ++expired2; }};
+    auto entry3 = std::make_unique<timer_wheel::entry>([&]{ ++expired3; });
+
+    wheel.arm(entry1, 5ms);
+    wheel.arm(entry2, 1h);
+    wheel.arm(*entry3, 5ms);
+    BOOST_TEST(wheel.size() == 3u);
+
+    // Rearming keeps a single deadline.
+    wheel.arm(entry1, 10ms);
+    BOOST_TEST(wheel.size() == 3u);
+    BOOST_TEST(entry1.armed());
+
+    // Cancelled and destroyed entries never expire.
+    entry2.cancel();
+    BOOST_TEST(!entry2.armed());
+    entry3.reset();
+    BOOST_TEST(wheel.size() == 1u);
+
+    ioc.run();
+    BOOST_TEST(expired1 == 1);
+    BOOST_TEST(expired2 == 0);
+    BOOST_TEST(expired3 == 0);
+    BOOST_TEST(!entry1.armed());
+    BOOST_TEST(wheel.size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_rounds)
+{
+    boost::asio::io_context ioc;
+    timer_wheel wheel {ioc.get_executor(), 1ms};
+
+    // A timeout longer than a full turn of the wheel.
+    int expired = 0;
+    timer_wheel::entry entry {[&]{ ++expired; }};
+    auto const timeout = wheel.tick() * (timer_wheel::slot_count + 10);
+    auto const start = timer_wheel::clock::now();
+    wheel.arm(entry, timeout);
+
+    ioc.run();
+    BOOST_TEST(expired == 1);
+    BOOST_TEST((timer_wheel::clock::now() - start >= timeout));
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_never_early)
+{
+    boost::asio::io_context ioc;
+    timer_wheel wheel {ioc.get_executor(), 20ms};
+
+    // Keeps the wheel ticking.
+    timer_wheel::entry ticker {[]{}};
+    wheel.arm(ticker, 1h);
+
+    // Armed halfway between two ticks of the running wheel.
+    int expired = 0;
+    timer_wheel::clock::time_point armed_at;
+    timer_wheel::clock::duration elapsed {};
+    timer_wheel::entry entry {[&]
+    {
+        ++expired;
+        elapsed = timer_wheel::clock::now() - armed_at;
+        ticker.cancel();
+    }};
+
+    boost::asio::steady_timer timer {ioc, 30ms};
+    timer.async_wait([&](auto)
+    {
+        armed_at = timer_wheel::clock::now();
+        wheel.arm(entry, wheel.tick());
+    });
+
+    ioc.run();
+    BOOST_TEST(expired == 1);
+    BOOST_TEST((elapsed >= wheel.tick()));
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_rearm_on_expiry)
+{
+    boost::asio::io_context ioc;
+    timer_wheel wheel {ioc.get_executor(), 1ms};
+
+    int expired = 0;
+    timer_wheel::entry entry {[&]
+    {
+        if (++expired < 3)
+        {
+            wheel.arm(entry, 2ms);
+        }
+    }};
+    wheel.arm(entry, 2ms);
+
+    ioc.run();
+    BOOST_TEST(expired == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_service)
+{
+    boost::asio::io_context ioc;
+    auto& wheel1 = boost::asio::use_service<timer_wheel_service>(ioc).wheel();
+    auto& wheel2 = boost::asio::use_service<timer_wheel_service>(ioc).wheel();
+    BOOST_TEST(&wheel1 == &wheel2);
+    BOOST_TEST((wheel1.tick() == timer_wheel::default_tick));
+}
+
+BOOST_AUTO_TEST_CASE(test_find_timer_wheel)
+{
+    // Only single threaded io_contexts share their wheel.
+    boost::asio::io_context single {1};
+    auto* wheel = find_timer_wheel(single.get_executor());
+    BOOST_TEST(wheel == &boost::asio::use_service<timer_wheel_service>(single).wheel());
+    BOOST_TEST(find_timer_wheel(boost::asio::make_strand(single)) == wheel);
+
+    boost::asio::io_context pool;
+    BOOST_TEST(find_timer_wheel(pool.get_executor()) == nullptr);
+    BOOST_TEST(find_timer_wheel(boost::asio::make_strand(pool)) == nullptr);
+}
+
+} // namespace